@@ -0,0 +1,853 @@
+/////////////////////////////////////////////////////////////
+// Headless batch mode for eight_tile_solver.
+//
+// Streams puzzles from a file or stdin, one per line, in the same digit
+// format doManualBoardSetup accepts (ex: 123056478). A line may carry a
+// second state to use as that puzzle's goal. Each puzzle is solved with
+// one algorithm (see getSolverAlgorithm) and one line is written per puzzle:
+//   <start> <number of moves> <moves>    (moves as L/R/U/D, the direction the tile slides)
+//   <start> unsolvable
+//   <line> invalid
+// or, with --format json or binary, one JSON object or fixed-width record
+// per puzzle (see result_writer.h).
+// Input and output go through large buffers and nothing is drawn to the
+// console, so millions of puzzles can be run through in one process.
+// Puzzles are spread across every core unless --threads 1 is given; output
+// order always matches input order. --size 4 or 5 solves 15- or 24-puzzles
+// with the NxN engines (see nxn_search.h). --filter solves nothing and
+// writes only the lines whose puzzle is solvable (see solvability.h), so a
+// stream can be cleaned before it is solved. --score solves nothing either:
+// each 3x3 start is given its Manhattan or misplaced-tile lower bound, scored
+// a chunk at a time by the batch kernels (see simd_heuristics.h).
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+#include "packed_state.h"
+#include "solvers.h"
+#include "work_stealing.h"
+#include "parallel_bfs.h"
+#include "nxn_board.h"
+#include "nxn_search.h"
+#include "pattern_db.h"
+#include "search_stats.h"
+#include "goal_canonical.h"
+#include "solvability.h"
+#include "instance_generator.h"
+#include "result_writer.h"
+#include "simd_heuristics.h"
+
+using namespace std;
+
+#define BATCH_BUFFER_SIZE (1 << 20)		// Bytes buffered on input and output
+#define BATCH_CHUNK_LINES 65536			// Lines read per parallel round
+#define BATCH_TASK_LINES 64				// Lines per work-stealing task
+
+struct BatchSummary
+{
+	unsigned int m_nSolved;
+	unsigned int m_nUnsolvable;
+	unsigned int m_nInvalid;
+	uint64_t m_nTotalMoves;
+	SearchStats m_Stats;		// Summed over the solved puzzles. Set m_Stats.m_bTimed to time every search's phases
+};
+
+bool parseStateString(string input, PackedState &state); //Parses 9 distinct digits 0-8. Returns false if invalid
+void solveBatchLine(string &line, SolverAlgorithm algorithm, PackedState goal, SearchContext &ctx, SearchResult &result, ResultWriter &writer, string &output, BatchSummary &summary);
+bool readBatchLine(istream &in, string &line); //Skips blank lines. Returns false at end of input
+void clearBatchSummary(BatchSummary &summary);
+void addBatchSummary(BatchSummary &total, BatchSummary &part);
+void runBatch(istream &in, ostream &out, SolverAlgorithm algorithm, PackedState goal, unsigned int nThreads, ResultWriter &writer, BatchSummary &summary); //Output is the same for any nThreads
+void runParallelLines(istream &in, ostream &out, WorkStealingScheduler &scheduler, BatchSummary &summary, function<void(unsigned int, string &, string &, BatchSummary &)> solveLine);
+template<int N> bool runSizedBatch(istream &in, ostream &out, SolverAlgorithm algorithm, BoardState<N> goal, string strGroups, unsigned int nThreads, ResultWriter &writer, BatchSummary &summary); //4x4 and 5x5 boards
+template<int N, class H> void runSizedBatch(istream &in, ostream &out, SolverAlgorithm algorithm, BoardState<N> goal, WorkStealingScheduler &scheduler, H **ppHeuristics, ResultWriter &writer, BatchSummary &summary);
+template<class S, class F> void runSolvabilityFilter(istream &in, ostream &out, S goal, bool (*parse)(string, S &), unsigned int nThreads, BatchSummary &summary); //Writes the solvable lines. F is the filter for state type S
+void runHeuristicScoring(istream &in, ostream &out, PackedState goal, HeuristicType type, BatchSummary &summary); //Writes each 3x3 line's lower bound. type must be H_MANHATTAN or H_MISPLACED
+template<int N> bool rebuildHeuristic(BoardManhattan<N> &heuristic, const BoardState<N> &goal); //Retargets a heuristic to a new goal. Returns false if it can't be
+template<int N> bool rebuildHeuristic(AdditivePatternHeuristic<N> &heuristic, const BoardState<N> &goal);
+int doBatchMode(int argc, char* argv[]); //Parses batch command line options and runs the batch. Returns the exit code
+int doLayerMode(int argc, char* argv[]); //Parses --bfs command line options and runs a parallel BFS. Returns the exit code
+int doGenerateMode(int argc, char* argv[]); //Parses --generate command line options and writes random puzzles. Returns the exit code
+template<int N> void writeRandomBoards(ostream &out, InstanceGenerator &generator, BoardState<N> goal, uint64_t nCount); //One line per board, as batch mode reads them
+
+//Parses a state string such as 123456780. Same rules as doManualBoardSetup: exactly
+//9 characters, each a digit 0-8, with no duplicates
+bool parseStateString(string input, PackedState &state)
+{
+	if (input.size() != 9)
+		return false;
+
+	int nState[9];
+	unsigned int nSeen = 0;
+	for (int i = 0; i < 9; i++)
+	{
+		int nTile = input[i] - '0';
+		if (nTile < 0 || nTile > 8 || (nSeen & (1u << nTile)))
+			return false;
+		nSeen |= 1u << nTile;
+		nState[i] = nTile;
+	}
+	state = packState(nState);
+	return true;
+}
+
+//Solves one input line, appending its result record to output and counting it in summary
+void solveBatchLine(string &line, SolverAlgorithm algorithm, PackedState goal, SearchContext &ctx, SearchResult &result, ResultWriter &writer, string &output, BatchSummary &summary)
+{
+	//"<start>" or "<start> <goal>"
+	PackedState start;
+	PackedState puzzleGoal = goal;
+	size_t nSpace = line.find(' ');
+	string strStart = line.substr(0, nSpace);
+	result.m_Stats.m_bTimed = summary.m_Stats.m_bTimed;
+	if (!parseStateString(strStart, start) || (nSpace != string::npos && !parseStateString(line.substr(nSpace + 1), puzzleGoal)))
+	{
+		writer.appendInvalid(output, line, 3);
+		summary.m_nInvalid++;
+		return;
+	}
+
+	int nTiles[9];
+	unpackState(start, nTiles);
+	if (!solvePuzzle(start, puzzleGoal, algorithm, ctx, result))
+	{
+		writer.appendUnsolvable(output, strStart, nTiles, 3);
+		summary.m_nUnsolvable++;
+	}
+	else
+	{
+		writer.appendSolved(output, strStart, nTiles, 3, result.m_Path, result.m_Stats);
+		summary.m_nSolved++;
+		summary.m_nTotalMoves += result.m_Path.size();
+		addSearchStats(summary.m_Stats, result.m_Stats);
+	}
+}
+
+//Reads the next line worth solving into line. Returns false at end of input
+bool readBatchLine(istream &in, string &line)
+{
+	while (getline(in, line))
+	{
+		if (!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1); //tolerate Windows line endings
+		if (!line.empty())
+			return true;
+	}
+	return false;
+}
+
+void clearBatchSummary(BatchSummary &summary)
+{
+	summary.m_nSolved = 0;
+	summary.m_nUnsolvable = 0;
+	summary.m_nInvalid = 0;
+	summary.m_nTotalMoves = 0;
+	clearSearchStats(summary.m_Stats);
+}
+
+void addBatchSummary(BatchSummary &total, BatchSummary &part)
+{
+	total.m_nSolved += part.m_nSolved;
+	total.m_nUnsolvable += part.m_nUnsolvable;
+	total.m_nInvalid += part.m_nInvalid;
+	total.m_nTotalMoves += part.m_nTotalMoves;
+	addSearchStats(total.m_Stats, part.m_Stats);
+}
+
+//Solves every puzzle read from in, writing one result per puzzle to out, on nThreads
+//threads (0 = one per hardware thread, 1 = the calling thread alone). Each thread
+//solves with its own SearchContext, so arenas and visited sets are never shared.
+//See runParallelLines
+void runBatch(istream &in, ostream &out, SolverAlgorithm algorithm, PackedState goal, unsigned int nThreads, ResultWriter &writer, BatchSummary &summary)
+{
+	WorkStealingScheduler scheduler(nThreads);
+	vector<SearchContext> vContexts(scheduler.getThreadCount());	//[nThread] = that thread's working memory
+	vector<SearchResult> vResults(scheduler.getThreadCount());
+	runParallelLines(in, out, scheduler, summary, [&](unsigned int nThread, string &line, string &output, BatchSummary &lineSummary)
+	{
+		solveBatchLine(line, algorithm, goal, vContexts[nThread], vResults[nThread], writer, output, lineSummary);
+	});
+}
+
+//Reads input BATCH_CHUNK_LINES lines at a time and splits each chunk into tasks of
+//BATCH_TASK_LINES lines, which the scheduler's threads share out by work stealing
+//(see work_stealing.h). solveLine(nThread, line, output, summary) is called for every
+//line. Each task's output goes to its own string, and those are written in task
+//order, so output is identical to a single-threaded run's.
+void runParallelLines(istream &in, ostream &out, WorkStealingScheduler &scheduler, BatchSummary &summary, function<void(unsigned int, string &, string &, BatchSummary &)> solveLine)
+{
+	clearBatchSummary(summary);
+	vector<string> vLines;
+	vector<string> vOutputs(BATCH_CHUNK_LINES / BATCH_TASK_LINES);	//[nTask] = result lines of that task
+	vector<BatchSummary> vSummaries(BATCH_CHUNK_LINES / BATCH_TASK_LINES);
+	vLines.reserve(BATCH_CHUNK_LINES);
+
+	string strLine;
+	bool bMoreInput = true;
+	while (bMoreInput)
+	{
+		//Read the next chunk
+		vLines.clear();
+		while (vLines.size() < BATCH_CHUNK_LINES && (bMoreInput = readBatchLine(in, strLine)))
+			vLines.push_back(strLine);
+		if (vLines.empty())
+			break;
+
+		//Solve it
+		unsigned int nTasks = (unsigned int)((vLines.size() + BATCH_TASK_LINES - 1) / BATCH_TASK_LINES);
+		scheduler.run(nTasks, [&](unsigned int nThread, unsigned int nTask)
+		{
+			string &output = vOutputs[nTask];
+			output.clear();
+			clearBatchSummary(vSummaries[nTask]);
+			vSummaries[nTask].m_Stats.m_bTimed = summary.m_Stats.m_bTimed;
+			size_t nLast = min(vLines.size(), (size_t)(nTask + 1) * BATCH_TASK_LINES);
+			for (size_t i = (size_t)nTask * BATCH_TASK_LINES; i < nLast; i++)
+				solveLine(nThread, vLines[i], output, vSummaries[nTask]);
+		});
+
+		//Write it in input order
+		for (unsigned int t = 0; t < nTasks; t++)
+		{
+			out.write(vOutputs[t].data(), vOutputs[t].size());
+			addBatchSummary(summary, vSummaries[t]);
+		}
+	}
+	out.flush();
+}
+
+//Batch for the NxN engines (see nxn_search.h) with heuristic class H, of which
+//ppHeuristics holds one per scheduler thread (entries may point to one shared,
+//read-only heuristic) built for goal's canonical goal. Every puzzle is solved as
+//its canonical equivalent (see goal_canonical.h); a line whose goal has another
+//canonical goal rebuilds its thread's heuristic when rebuildHeuristic allows it,
+//else the line is invalid.
+template<int N, class H>
+void runSizedBatch(istream &in, ostream &out, SolverAlgorithm algorithm, BoardState<N> goal, WorkStealingScheduler &scheduler, H **ppHeuristics, ResultWriter &writer, BatchSummary &summary)
+{
+	vector<MoveString> vPaths(scheduler.getThreadCount());
+	vector< BoardSearchContext<N> > vContexts(scheduler.getThreadCount());	//[nThread] = that thread's A* working memory
+	vector< GoalCanonicalizer<N> > vCanonicalizers(scheduler.getThreadCount());	//[nThread] = mapping for that thread's last goal
+	vector< BoardSolvabilityFilter<N> > vFilters(scheduler.getThreadCount());	//[nThread] = parity of that thread's last goal
+	for (unsigned int t = 0; t < vCanonicalizers.size(); t++)
+		buildGoalCanonicalizer(goal, vCanonicalizers[t]);
+	runParallelLines(in, out, scheduler, summary, [&](unsigned int nThread, string &line, string &output, BatchSummary &lineSummary)
+	{
+		//"<start>" or "<start> <goal>"
+		H &heuristic = *ppHeuristics[nThread];
+		GoalCanonicalizer<N> &canon = vCanonicalizers[nThread];
+		BoardState<N> start;
+		BoardState<N> puzzleGoal = goal;
+		size_t nSpace = line.find(' ');
+		string strStart = line.substr(0, nSpace);
+		int nTiles[N * N];
+		bool bValid = parseBoardString<N>(strStart, start) && (nSpace == string::npos || parseBoardString<N>(line.substr(nSpace + 1), puzzleGoal));
+		if (bValid)
+		{
+			//Reject unsolvable puzzles before a goal's mapping or heuristic is built
+			unpackBoard(start, nTiles);
+			BoardSolvabilityFilter<N> &solvability = vFilters[nThread];
+			solvability.setGoal(puzzleGoal);
+			if (!solvability.isSolvable(start))
+			{
+				writer.appendUnsolvable(output, strStart, nTiles, N);
+				lineSummary.m_nUnsolvable++;
+				return;
+			}
+
+			int nGoal[N * N];
+			unpackBoard(puzzleGoal, nGoal);
+			if (!isCanonicalizerFor(canon, nGoal))
+				buildGoalCanonicalizer<N>(nGoal, canon);
+			BoardState<N> canonicalGoal = getCanonicalBoardGoal(canon);
+			bValid = heuristic.getGoal() == canonicalGoal || rebuildHeuristic(heuristic, canonicalGoal);
+		}
+		if (!bValid)
+		{
+			writer.appendInvalid(output, line, N);
+			lineSummary.m_nInvalid++;
+			return;
+		}
+
+		SearchStats stats;
+		stats.m_bTimed = lineSummary.m_Stats.m_bTimed;
+		start = canonicalizeBoard(canon, start);
+		bool bSolved = (algorithm.m_Engine == ENGINE_ASTAR) ? solveBoardAStar(start, heuristic, vContexts[nThread], vPaths[nThread], stats)
+			: solveBoardIDAStar(start, heuristic, vPaths[nThread], stats);
+		restoreMoves(canon, vPaths[nThread]);
+		if (!bSolved)
+		{
+			writer.appendUnsolvable(output, strStart, nTiles, N);
+			lineSummary.m_nUnsolvable++;
+			return;
+		}
+		writer.appendSolved(output, strStart, nTiles, N, vPaths[nThread], stats);
+		lineSummary.m_nSolved++;
+		lineSummary.m_nTotalMoves += vPaths[nThread].size();
+		addSearchStats(lineSummary.m_Stats, stats);
+	});
+}
+
+//Manhattan tables are small and per thread, so they follow each line's goal
+template<int N>
+bool rebuildHeuristic(BoardManhattan<N> &heuristic, const BoardState<N> &goal)
+{
+	heuristic.build(goal);
+	return true;
+}
+
+//Pattern databases are shared by every thread and take seconds to build, so one canonical
+//goal is used throughout: line goals must have their blank in the same symmetry class
+template<int N>
+bool rebuildHeuristic(AdditivePatternHeuristic<N> & /*heuristic*/, const BoardState<N> & /*goal*/)
+{
+	return false;
+}
+
+//Sets up the heuristic algorithm names for size N and runs the batch. Returns false
+//if the pattern databases can't be opened or built
+template<int N>
+bool runSizedBatch(istream &in, ostream &out, SolverAlgorithm algorithm, BoardState<N> goal, string strGroups, unsigned int nThreads, ResultWriter &writer, BatchSummary &summary)
+{
+	WorkStealingScheduler scheduler(nThreads);
+	GoalCanonicalizer<N> canon;
+	buildGoalCanonicalizer(goal, canon);
+	BoardState<N> canonicalGoal = getCanonicalBoardGoal(canon);
+	if (algorithm.m_Heuristic == H_PATTERN_DB)
+	{
+		vector< vector<int> > vGroups;
+		if (!(strGroups.empty() ? getDefaultPatternGroups<N>(vGroups) : parsePatternGroups(strGroups, vGroups)))
+			return false;
+		AdditivePatternHeuristic<N> heuristic;
+		if (!heuristic.build(canonicalGoal, vGroups))
+			return false;
+		vector< AdditivePatternHeuristic<N>* > vHeuristics(scheduler.getThreadCount(), &heuristic);
+		runSizedBatch<N>(in, out, algorithm, goal, scheduler, &vHeuristics[0], writer, summary);
+		return true;
+	}
+
+	vector< BoardManhattan<N> > vTables(scheduler.getThreadCount());
+	vector< BoardManhattan<N>* > vHeuristics;
+	for (unsigned int t = 0; t < vTables.size(); t++)
+	{
+		vTables[t].build(canonicalGoal);
+		vHeuristics.push_back(&vTables[t]);
+	}
+	runSizedBatch<N>(in, out, algorithm, goal, scheduler, &vHeuristics[0], writer, summary);
+	return true;
+}
+
+//Copies every line whose puzzle is solvable from in to out, unchanged, and counts
+//them as solved in summary. Nothing is searched; each line costs a parse and one
+//parity, since each thread's filter F keeps the goal's parity until a line names
+//another goal. Lines are shared out as runBatch does, so output keeps input order.
+template<class S, class F>
+void runSolvabilityFilter(istream &in, ostream &out, S goal, bool (*parse)(string, S &), unsigned int nThreads, BatchSummary &summary)
+{
+	WorkStealingScheduler scheduler(nThreads);
+	vector<F> vFilters(scheduler.getThreadCount());	//[nThread] = parity of that thread's last goal
+	runParallelLines(in, out, scheduler, summary, [&](unsigned int nThread, string &line, string &output, BatchSummary &lineSummary)
+	{
+		//"<start>" or "<start> <goal>"
+		S start;
+		S puzzleGoal = goal;
+		size_t nSpace = line.find(' ');
+		if (!parse(line.substr(0, nSpace), start) || (nSpace != string::npos && !parse(line.substr(nSpace + 1), puzzleGoal)))
+		{
+			lineSummary.m_nInvalid++;
+			return;
+		}
+		F &filter = vFilters[nThread];
+		filter.setGoal(puzzleGoal);
+		if (!filter.isSolvable(start))
+		{
+			lineSummary.m_nUnsolvable++;
+			return;
+		}
+		output += line;
+		output += '\n';
+		lineSummary.m_nSolved++;
+	});
+}
+
+//Writes "<start> <h>" for every line, where h is type's lower bound on its moves, or
+//"<start> unsolvable" / "<line> invalid" as a batch would. Lines are read
+//BATCH_CHUNK_LINES at a time and each run of lines sharing a goal is scored in one
+//BatchTileHeuristic call, which retargets its tables only when the goal changes.
+//summary counts scored lines as solved, with m_nTotalMoves the sum of their bounds.
+void runHeuristicScoring(istream &in, ostream &out, PackedState goal, HeuristicType type, BatchSummary &summary)
+{
+	clearBatchSummary(summary);
+	BatchTileHeuristic kernel;
+	kernel.build(goal, type);
+	PackedState kernelGoal = goal;
+	SolvabilityFilter filter;
+	vector<string> vLines;
+	vector<ResultStatus> vStatus;
+	vector<PackedState> vStarts;
+	vector<PackedState> vGoals;
+	vector<int> vBounds;
+	string strLine;
+	string strOutput;
+	strOutput.reserve(BATCH_BUFFER_SIZE + 256);
+
+	bool bMoreInput = true;
+	while (bMoreInput)
+	{
+		vLines.clear();
+		while (vLines.size() < BATCH_CHUNK_LINES && (bMoreInput = readBatchLine(in, strLine)))
+			vLines.push_back(strLine);
+		if (vLines.empty())
+			break;
+
+		//Parse the chunk. Lines that aren't scored take the previous goal so they don't split a run
+		vStatus.resize(vLines.size());
+		vStarts.resize(vLines.size());
+		vGoals.resize(vLines.size());
+		vBounds.resize(vLines.size());
+		PackedState lastGoal = kernelGoal;
+		for (size_t i = 0; i < vLines.size(); i++)
+		{
+			size_t nSpace = vLines[i].find(' ');
+			PackedState puzzleGoal = goal;
+			if (!parseStateString(vLines[i].substr(0, nSpace), vStarts[i]) || (nSpace != string::npos && !parseStateString(vLines[i].substr(nSpace + 1), puzzleGoal)))
+				vStatus[i] = RESULT_INVALID;
+			else
+			{
+				filter.setGoal(puzzleGoal);
+				vStatus[i] = filter.isSolvable(vStarts[i]) ? RESULT_SOLVED : RESULT_UNSOLVABLE;
+			}
+			if (vStatus[i] != RESULT_SOLVED)
+			{
+				vStarts[i] = lastGoal;
+				puzzleGoal = lastGoal;
+			}
+			vGoals[i] = lastGoal = puzzleGoal;
+		}
+
+		//Score it
+		for (size_t i = 0, j; i < vLines.size(); i = j)
+		{
+			for (j = i + 1; j < vLines.size() && vGoals[j] == vGoals[i]; j++)
+				;
+			if (vGoals[i] != kernelGoal)
+			{
+				kernelGoal = vGoals[i];
+				kernel.build(kernelGoal, type);
+			}
+			kernel.evaluate(&vStarts[i], j - i, &vBounds[i]);
+		}
+
+		//Write it
+		for (size_t i = 0; i < vLines.size(); i++)
+		{
+			string strStart = vLines[i].substr(0, vLines[i].find(' '));
+			if (vStatus[i] == RESULT_INVALID)
+			{
+				strOutput += vLines[i];
+				strOutput += " invalid\n";
+				summary.m_nInvalid++;
+			}
+			else if (vStatus[i] == RESULT_UNSOLVABLE)
+			{
+				strOutput += strStart;
+				strOutput += " unsolvable\n";
+				summary.m_nUnsolvable++;
+			}
+			else
+			{
+				strOutput += strStart;
+				strOutput += ' ';
+				strOutput += to_string(vBounds[i]);
+				strOutput += '\n';
+				summary.m_nSolved++;
+				summary.m_nTotalMoves += vBounds[i];
+			}
+			if (strOutput.size() >= BATCH_BUFFER_SIZE)
+			{
+				out.write(strOutput.data(), strOutput.size());
+				strOutput.clear();
+			}
+		}
+	}
+	out.write(strOutput.data(), strOutput.size());
+	out.flush();
+}
+
+//Batch command line: eight_tile.exe --batch [--size N] [--alg NAME] [--goal STATE] [--groups GROUPS] [--threads N] [--stats] [--timers] [--format FORMAT] [--filter] [--score] [FILE]
+//Reads stdin when FILE is omitted or is "-". Results go to stdout, a summary to stderr.
+//Sizes 4 and 5 take states as hex digits (4x4 only) or comma separated tiles.
+//GROUPS partitions the tiles for -pdb (ex: 1,5,6,9,10,13/7,8,11,12,14,15/2,3,4).
+//--stats adds the summed search statistics to the summary as JSON, --timers also times each search phase.
+//--format picks text (the default), json or binary results (see result_writer.h).
+//--filter writes the solvable lines instead of solving them (see runSolvabilityFilter). It writes no result records, so it takes no --format.
+//--score writes each 3x3 line's lower bound from NAME's heuristic, -manhattan or -toop (see runHeuristicScoring). It runs on one thread and takes no --format.
+int doBatchMode(int argc, char* argv[])
+{
+	int nSize = 3;
+	string strAlgorithm;
+	string strGoal;
+	string strGroups;
+	string strFile = "-";
+	unsigned int nThreads = 0;
+	bool bStats = false;
+	bool bTimers = false;
+	bool bFilter = false;
+	bool bScore = false;
+	bool bThreadsGiven = false;
+	string strFormat;
+	for (int i = 2; i < argc; i++)
+	{
+		string strArg = argv[i];
+		if (strArg == "--alg" && i + 1 < argc)
+			strAlgorithm = argv[++i];
+		else if (strArg == "--stats")
+			bStats = true;
+		else if (strArg == "--timers")
+			bStats = bTimers = true;
+		else if (strArg == "--filter")
+			bFilter = true;
+		else if (strArg == "--score")
+			bScore = true;
+		else if (strArg == "--format" && i + 1 < argc)
+			strFormat = argv[++i];
+		else if (strArg == "--goal" && i + 1 < argc)
+			strGoal = argv[++i];
+		else if (strArg == "--groups" && i + 1 < argc)
+			strGroups = argv[++i];
+		else if (strArg == "--threads" && i + 1 < argc)
+		{
+			nThreads = (unsigned int)atoi(argv[++i]);
+			bThreadsGiven = true;
+		}
+		else if (strArg == "--size" && i + 1 < argc)
+			nSize = atoi(argv[++i]);
+		else
+			strFile = strArg;
+	}
+	if (nSize < 3 || nSize > 5)
+	{
+		cerr << "Unsupported size " << nSize << ". Use 3, 4 or 5.\n";
+		return 1;
+	}
+	if (strAlgorithm.empty())
+		strAlgorithm = (nSize == 3) ? (bScore ? "ida-manhattan" : "ida-wd") : "ida-pdb";
+
+	if ((bFilter || bScore) && !strFormat.empty())
+	{
+		cerr << "--filter and --score write input lines or bounds, not results, so they take no --format.\n";
+		return 1;
+	}
+	if (bScore && bThreadsGiven && nThreads != 1)
+	{
+		cerr << "--score runs on one thread. Use --threads 1 or leave it out.\n";
+		return 1;
+	}
+	ResultFormat format = FORMAT_TEXT;
+	if (!strFormat.empty() && !getResultFormat(strFormat, format))
+	{
+		cerr << "Unknown format " << strFormat << ". Use text, json or binary.\n";
+		return 1;
+	}
+	ResultWriter writer(format);
+
+	SolverAlgorithm algorithm;
+	if (!getSolverAlgorithm(strAlgorithm, algorithm))
+	{
+		cerr << "Unknown algorithm " << strAlgorithm << ". Use bfs, bibfs, db, greedy[-h], astar[-h], ida[-h] or biastar[-h] where h is toop, manhattan, lc, wd or pdb.\n";
+		return 1;
+	}
+	if (nSize > 3 && ((algorithm.m_Engine != ENGINE_IDASTAR && algorithm.m_Engine != ENGINE_ASTAR) || (algorithm.m_Heuristic != H_MANHATTAN && algorithm.m_Heuristic != H_PATTERN_DB)))
+	{
+		cerr << "Size " << nSize << " supports ida and astar with -manhattan or -pdb only.\n";
+		return 1;
+	}
+	if (bScore && (nSize != 3 || (algorithm.m_Heuristic != H_MANHATTAN && algorithm.m_Heuristic != H_MISPLACED)))
+	{
+		cerr << "--score is for size 3 with the -manhattan or -toop heuristic.\n";
+		return 1;
+	}
+	if (nSize == 3 && algorithm.m_Heuristic == H_PATTERN_DB)
+	{
+		cerr << "Pattern databases are for sizes 4 and 5. Use db for the exact 3x3 table.\n";
+		return 1;
+	}
+
+	PackedState goal;
+	parseStateString("123456780", goal);
+	BoardState<4> goal4 = getDefaultGoal<4>();
+	BoardState<5> goal5 = getDefaultGoal<5>();
+	if (!strGoal.empty() && !((nSize == 3 && parseStateString(strGoal, goal)) || (nSize == 4 && parseBoardString<4>(strGoal, goal4))
+		|| (nSize == 5 && parseBoardString<5>(strGoal, goal5))))
+	{
+		cerr << "Invalid goal " << strGoal << ". Enter it as a string of digits (ex: 123456780).\n";
+		return 1;
+	}
+
+	//Large stream buffers, and no syncing with C stdio, keep I/O off the profile
+	ios::sync_with_stdio(false);
+#ifdef _WIN32
+	if (format == FORMAT_BINARY)
+		_setmode(_fileno(stdout), _O_BINARY); //records must not get \r added before 0x0A bytes
+#endif
+	static char chOutBuffer[BATCH_BUFFER_SIZE]; //static: cout keeps using it after this function returns, until it is flushed at exit
+	vector<char> vInBuffer(BATCH_BUFFER_SIZE);
+	cout.rdbuf()->pubsetbuf(chOutBuffer, sizeof(chOutBuffer));
+
+	ifstream file;
+	istream *pIn = &cin;
+	if (strFile != "-")
+	{
+		file.rdbuf()->pubsetbuf(&vInBuffer[0], vInBuffer.size());
+		file.open(strFile.c_str());
+		if (!file.is_open())
+		{
+			cerr << "Could not open " << strFile << ".\n";
+			return 1;
+		}
+		pIn = &file;
+	}
+
+	//Wall time, since clock() would add up the CPU time of every thread
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	BatchSummary summary;
+	summary.m_Stats.m_bTimed = bTimers;
+	bool bRan = true;
+	if (bFilter)
+	{
+		if (nSize == 4)
+			runSolvabilityFilter< BoardState<4>, BoardSolvabilityFilter<4> >(*pIn, cout, goal4, parseBoardString<4>, nThreads, summary);
+		else if (nSize == 5)
+			runSolvabilityFilter< BoardState<5>, BoardSolvabilityFilter<5> >(*pIn, cout, goal5, parseBoardString<5>, nThreads, summary);
+		else
+			runSolvabilityFilter<PackedState, SolvabilityFilter>(*pIn, cout, goal, parseStateString, nThreads, summary);
+		cerr << "Kept " << summary.m_nSolved << " solvable puzzles (" << summary.m_nUnsolvable << " unsolvable, " << summary.m_nInvalid << " invalid) in ";
+		cerr << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " s.\n";
+		return 0;
+	}
+	if (bScore)
+	{
+		runHeuristicScoring(*pIn, cout, goal, algorithm.m_Heuristic, summary);
+		cerr << "Scored " << summary.m_nSolved << " puzzles (" << summary.m_nUnsolvable << " unsolvable, " << summary.m_nInvalid << " invalid) in ";
+		cerr << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " s";
+		if (summary.m_nSolved > 0)
+			cerr << ", average lower bound " << (double)summary.m_nTotalMoves / summary.m_nSolved << " moves";
+		cerr << ".\n";
+		return 0;
+	}
+	if (nSize == 4)
+		bRan = runSizedBatch<4>(*pIn, cout, algorithm, goal4, strGroups, nThreads, writer, summary);
+	else if (nSize == 5)
+		bRan = runSizedBatch<5>(*pIn, cout, algorithm, goal5, strGroups, nThreads, writer, summary);
+	else
+		runBatch(*pIn, cout, algorithm, goal, nThreads, writer, summary);
+	double dSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	if (!bRan)
+	{
+		cerr << "Could not open or generate the pattern databases. Groups must split tiles 1 to " << nSize * nSize - 1 << " with at most " << (nSize == 4 ? getMaxPatternTiles<4>() : getMaxPatternTiles<5>()) << " tiles per group.\n";
+		return 1;
+	}
+
+	cerr << "Solved " << summary.m_nSolved << " puzzles (" << summary.m_nUnsolvable << " unsolvable, " << summary.m_nInvalid << " invalid) in " << dSeconds << " s";
+	if (summary.m_nSolved > 0)
+		cerr << ", average " << (double)summary.m_nTotalMoves / summary.m_nSolved << " moves and " << (double)summary.m_Stats.m_nExpanded / summary.m_nSolved << " nodes expanded";
+	cerr << ".\n";
+	if (bStats)
+		cerr << getSearchStatsJson(summary.m_Stats) << "\n";
+	return 0;
+}
+
+//Layer command line: eight_tile.exe --bfs [--goal DIGITS] [--threads N] [START]
+//Runs the level-synchronous parallel BFS (see parallel_bfs.h) from the goal over the
+//whole state space and prints the number of states at each depth. Given START, stops
+//once START is reached and prints an optimal solution for it instead.
+int doLayerMode(int argc, char* argv[])
+{
+	string strGoal = "123456780";
+	string strStart;
+	unsigned int nThreads = 0;
+	for (int i = 2; i < argc; i++)
+	{
+		string strArg = argv[i];
+		if (strArg == "--goal" && i + 1 < argc)
+			strGoal = argv[++i];
+		else if (strArg == "--threads" && i + 1 < argc)
+			nThreads = (unsigned int)atoi(argv[++i]);
+		else
+			strStart = strArg;
+	}
+
+	PackedState goal;
+	PackedState start;
+	if (!parseStateString(strGoal, goal) || (!strStart.empty() && !parseStateString(strStart, start)))
+	{
+		cerr << "Invalid state. Enter it as a string of digits (ex: 123456780).\n";
+		return 1;
+	}
+
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	if (!strStart.empty())
+	{
+		MoveString path;
+		if (!solveParallelBFS(start, goal, nThreads, path))
+			cout << strStart << " unsolvable\n";
+		else
+		{
+			string strOutput = strStart + ' ' + to_string(path.size()) + ' ';
+			appendMoveString(strOutput, path);
+			cout << strOutput << '\n';
+		}
+	}
+	else
+	{
+		vector<unsigned char> vDepths;
+		vector<unsigned int> vLayerSizes;
+		unsigned int nReached = runParallelBFS(goal, nThreads, vDepths, vLayerSizes);
+		cout << "depth states\n";
+		for (unsigned int d = 0; d < vLayerSizes.size(); d++)
+			cout << d << ' ' << vLayerSizes[d] << '\n';
+		cout << "total " << nReached << '\n';
+	}
+	double dSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	cerr << "Searched on " << WorkStealingScheduler(nThreads).getThreadCount() << " threads in " << dSeconds << " s.\n";
+	return 0;
+}
+
+template<int N>
+void writeRandomBoards(ostream &out, InstanceGenerator &generator, BoardState<N> goal, uint64_t nCount)
+{
+	string strOutput;
+	strOutput.reserve(BATCH_BUFFER_SIZE + 256);
+	for (uint64_t i = 0; i < nCount; i++)
+	{
+		int nTiles[N * N];
+		unpackBoard(generator.nextBoard<N>(goal), nTiles);
+		for (int p = 0; p < N * N; p++)
+		{
+			if (N * N > 16)
+			{
+				if (p > 0)
+					strOutput += ',';
+				strOutput += to_string(nTiles[p]);
+			}
+			else
+				strOutput += "0123456789ABCDEF"[nTiles[p]];
+		}
+		strOutput += '\n';
+		if (strOutput.size() >= BATCH_BUFFER_SIZE)
+		{
+			out.write(strOutput.data(), strOutput.size());
+			strOutput.clear();
+		}
+	}
+	out.write(strOutput.data(), strOutput.size());
+	out.flush();
+}
+
+//Generate command line: eight_tile.exe --generate COUNT [--seed S] [--depth D] [--size N] [--goal STATE]
+//Writes COUNT random puzzles that can reach the goal, one per line in the format batch
+//mode reads, so the same seed always gives the same input. 3x3 puzzles are uniform over
+//every solvable start, or, with --depth, over those D moves from the goal, drawn from
+//the goal's distance database (generated on first use).
+int doGenerateMode(int argc, char* argv[])
+{
+	uint64_t nCount = 0;
+	uint64_t nSeed = 2016;
+	int nDepth = -1;
+	int nSize = 3;
+	string strGoal;
+	for (int i = 2; i < argc; i++)
+	{
+		string strArg = argv[i];
+		if (strArg == "--seed" && i + 1 < argc)
+			nSeed = strtoull(argv[++i], nullptr, 10);
+		else if (strArg == "--depth" && i + 1 < argc)
+			nDepth = atoi(argv[++i]);
+		else if (strArg == "--size" && i + 1 < argc)
+			nSize = atoi(argv[++i]);
+		else if (strArg == "--goal" && i + 1 < argc)
+			strGoal = argv[++i];
+		else
+			nCount = strtoull(argv[i], nullptr, 10);
+	}
+	if (nSize < 3 || nSize > 5 || (nDepth >= 0 && nSize != 3))
+	{
+		cerr << "Unsupported size " << nSize << ". Use 3, 4 or 5, and 3 with --depth.\n";
+		return 1;
+	}
+
+	PackedState goal;
+	parseStateString("123456780", goal);
+	BoardState<4> goal4 = getDefaultGoal<4>();
+	BoardState<5> goal5 = getDefaultGoal<5>();
+	if (!strGoal.empty() && !((nSize == 3 && parseStateString(strGoal, goal)) || (nSize == 4 && parseBoardString<4>(strGoal, goal4))
+		|| (nSize == 5 && parseBoardString<5>(strGoal, goal5))))
+	{
+		cerr << "Invalid goal " << strGoal << ". Enter it as a string of digits (ex: 123456780).\n";
+		return 1;
+	}
+
+	ios::sync_with_stdio(false);
+	InstanceGenerator generator(nSeed);
+	if (nSize == 4)
+	{
+		writeRandomBoards<4>(cout, generator, goal4, nCount);
+		return 0;
+	}
+	if (nSize == 5)
+	{
+		writeRandomBoards<5>(cout, generator, goal5, nCount);
+		return 0;
+	}
+
+	DistanceDatabase db;
+	if (nDepth >= 0)
+	{
+		if (!db.open(goal))
+		{
+			cerr << "Could not open or generate " << getDistanceDatabaseName(goal) << ".\n";
+			return 1;
+		}
+		vector< vector<int> > vRanksByDepth;
+		db.getRanksByDepth(vRanksByDepth);
+		generator.setDepthIndex(goal, vRanksByDepth);
+	}
+	string strOutput;
+	strOutput.reserve(BATCH_BUFFER_SIZE + 256);
+	for (uint64_t i = 0; i < nCount; i++)
+	{
+		PackedState state;
+		if (nDepth < 0)
+			state = generator.next(goal);
+		else if (!generator.nextAtDepth(nDepth, state))
+		{
+			cerr << "No state is " << nDepth << " moves from the goal. The deepest is " << generator.getMaxDepth() << ".\n";
+			return 1;
+		}
+		for (int p = 0; p < 9; p++)
+			strOutput += (char)('0' + getPackedTile(state, p));
+		strOutput += '\n';
+		if (strOutput.size() >= BATCH_BUFFER_SIZE)
+		{
+			cout.write(strOutput.data(), strOutput.size());
+			strOutput.clear();
+		}
+	}
+	cout.write(strOutput.data(), strOutput.size());
+	cout.flush();
+	return 0;
+}
@@ -0,0 +1,319 @@
+/////////////////////////////////////////////////////////////
+// Benchmark for eight_tile_solver.
+//
+// Runs each algorithm over a fixed corpus for the goal 123456780: K puzzles
+// at every optimal depth from 0 to 31, drawn from the distance database with
+// InstanceGenerator (see instance_generator.h), so a seed gives the same
+// puzzles on every run, plus the two hardest 8-puzzle instances (31 moves).
+// Each puzzle is solved once untimed before the timed runs, so tables built
+// per start (the backward heuristic of biastar) and container growth are
+// never timed. One JSON object is written per run, holding its SearchStats
+// (see search_stats.h) and peak memory, and one summary object per
+// algorithm, so results can be diffed or loaded by a script to track
+// regressions. With --heuristics the batch heuristic kernels (see
+// simd_heuristics.h) also score every state of the goal's parity class at
+// each SIMD level the CPU supports, checked against the scalar tables.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2017
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdlib.h>
+#include "solvers.h"
+#include "batch_solver.h"
+#include "simd_heuristics.h"
+#include "instance_generator.h"
+
+using namespace std;
+
+#define BENCH_GOAL "123456780"
+#define BENCH_MAX_DEPTH 31		// Deepest optimal solution on the 8-puzzle
+
+//Classic hardest instances for the goal above, both 31 moves
+const char* g_chHardest[] = { "867254301", "647850321" };
+
+//Default algorithms, covering every engine and heuristic
+const char* g_chAlgorithms[] = { "bfs", "bibfs", "db", "greedy", "astar-toop", "astar", "astar-lc", "astar-wd", "ida", "ida-lc", "ida-wd", "biastar" };
+
+struct BenchInstance
+{
+	string m_strName;		// Start state as digits
+	string m_strSet;		// "depth" for sampled puzzles, "hardest" for g_chHardest
+	PackedState m_State;
+	int m_nDepth;			// Optimal solution length
+};
+
+//Totals over one algorithm's runs
+struct BenchSummary
+{
+	int m_nRuns;
+	int m_nOptimal;			// Runs whose solution had the optimal length
+	double m_dSeconds;
+	size_t m_nPeakNodeBytes;
+	size_t m_nPeakSearchBytes;
+	SearchStats m_Stats;	// Summed counts, largest peaks
+};
+
+bool buildBenchCorpus(PackedState goal, int nPerDepth, unsigned int nSeed, vector<BenchInstance> &vCorpus); //Samples nPerDepth puzzles per depth, plus the hardest instances
+void runBenchmark(string strAlgorithm, SolverAlgorithm algorithm, PackedState goal, vector<BenchInstance> &vCorpus, int nRepeat, bool bTimers, ostream &out);
+double getNodesPerSecond(uint64_t nNodes, double dSeconds);
+size_t getPeakSearchBytes(SearchContext &ctx, SolverAlgorithm algorithm, const SearchStats &stats); //Node arena, visited sets and open list at their peaks
+void runHeuristicBenchmark(PackedState goal, int nRepeat, ostream &out); //Times the batch heuristic kernels over every state of goal's parity class
+
+//Groups the goal's states by depth with the distance database and picks nPerDepth
+//of each depth at random (all of them where fewer exist)
+bool buildBenchCorpus(PackedState goal, int nPerDepth, unsigned int nSeed, vector<BenchInstance> &vCorpus)
+{
+	DistanceDatabase db;
+	if (!db.open(goal))
+		return false;
+
+	vector< vector<int> > vRanksByDepth;
+	db.getRanksByDepth(vRanksByDepth);
+	InstanceGenerator generator(nSeed);
+	int nParity = getStateParity(goal);
+	vCorpus.clear();
+	for (int nDepth = 0; nDepth <= BENCH_MAX_DEPTH && nDepth < (int)vRanksByDepth.size(); nDepth++)
+	{
+		vector<int> &vRanks = vRanksByDepth[nDepth];
+		for (int i = 0; i < nPerDepth && i < (int)vRanks.size(); i++)
+		{
+			//partial Fisher-Yates shuffle, so no state is picked twice
+			swap(vRanks[i], vRanks[i + generator.getUniform(vRanks.size() - i)]);
+
+			BenchInstance instance;
+			instance.m_State = unrankState(vRanks[i], nParity);
+			for (int p = 0; p < 9; p++)
+				instance.m_strName += (char)('0' + getPackedTile(instance.m_State, p));
+			instance.m_strSet = "depth";
+			instance.m_nDepth = nDepth;
+			vCorpus.push_back(instance);
+		}
+	}
+
+	for (unsigned int i = 0; i < sizeof(g_chHardest) / sizeof(g_chHardest[0]); i++)
+	{
+		BenchInstance instance;
+		instance.m_strName = g_chHardest[i];
+		instance.m_strSet = "hardest";
+		parseStateString(instance.m_strName, instance.m_State);
+		instance.m_nDepth = db.getDistance(instance.m_State);
+		vCorpus.push_back(instance);
+	}
+	return true;
+}
+
+double getNodesPerSecond(uint64_t nNodes, double dSeconds)
+{
+	return (dSeconds > 0) ? nNodes / dSeconds : 0;
+}
+
+//The arena's high water mark, the closed list the engine uses (visited sets are emptied
+//to their initial size before each puzzle, so their capacity is what this puzzle
+//needed), and a pointer per node at the open list's peak (the path for IDA*).
+//Heuristic tables and the database are shared by every puzzle and left out.
+size_t getPeakSearchBytes(SearchContext &ctx, SolverAlgorithm algorithm, const SearchStats &stats)
+{
+	size_t nBytes = ctx.m_Pool.getPeakBytesUsed() + (size_t)stats.m_nPeakOpen * sizeof(Node*);
+	switch (algorithm.m_Engine)
+	{
+	case ENGINE_BFS:
+		return nBytes + sizeof(VisitedBitmap);
+	case ENGINE_GREEDY:
+	case ENGINE_ASTAR:
+		return nBytes + ctx.m_Visited.getBytesReserved();
+	case ENGINE_BIDIRECTIONAL_BFS:
+	case ENGINE_BIDIRECTIONAL_ASTAR:
+		return nBytes + ctx.m_Visited.getBytesReserved() + ctx.m_BackwardVisited.getBytesReserved();
+	default:
+		return nBytes;
+	}
+}
+
+//Solves every corpus puzzle nRepeat times, writing the fastest time of each with the
+//search statistics (see search_stats.h), which are the same on every repeat. Each
+//puzzle is first solved untimed, which builds any heuristic tables or database for
+//its goal and start and grows the context to the size the puzzle needs; memory is
+//measured on that run. With bTimers, phase times are measured too, at some cost to
+//the wall times.
+void runBenchmark(string strAlgorithm, SolverAlgorithm algorithm, PackedState goal, vector<BenchInstance> &vCorpus, int nRepeat, bool bTimers, ostream &out)
+{
+	SearchContext ctx;
+	SearchResult result;
+	result.m_Stats.m_bTimed = bTimers;
+
+	BenchSummary summary;
+	summary.m_nRuns = 0;
+	summary.m_nOptimal = 0;
+	summary.m_dSeconds = 0;
+	summary.m_nPeakNodeBytes = 0;
+	summary.m_nPeakSearchBytes = 0;
+	summary.m_Stats.m_bTimed = bTimers;
+	for (unsigned int i = 0; i < vCorpus.size(); i++)
+	{
+		BenchInstance &instance = vCorpus[i];
+		ctx.m_Visited = VisitedSet();
+		ctx.m_BackwardVisited = VisitedSet();
+		ctx.m_Pool.releaseAll();
+		ctx.m_Pool.resetPeak();
+		solvePuzzle(instance.m_State, goal, algorithm, ctx, result);
+		size_t nNodeBytes = ctx.m_Pool.getPeakBytesUsed();
+		size_t nSearchBytes = getPeakSearchBytes(ctx, algorithm, result.m_Stats);
+
+		double dSeconds = 0;
+		bool bSolved = false;
+		for (int r = 0; r < nRepeat; r++)
+		{
+			ctx.m_Pool.releaseAll();
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			bSolved = solvePuzzle(instance.m_State, goal, algorithm, ctx, result);
+			double dRun = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			if (r == 0 || dRun < dSeconds)
+				dSeconds = dRun;
+		}
+
+		int nMoves = bSolved ? (int)result.m_Path.size() : -1;
+		out << "{\"alg\":\"" << strAlgorithm << "\",\"set\":\"" << instance.m_strSet << "\",\"start\":\"" << instance.m_strName << "\"";
+		out << ",\"depth\":" << instance.m_nDepth << ",\"moves\":" << nMoves << ",\"seconds\":" << dSeconds;
+		out << ",\"nodes_per_sec\":" << getNodesPerSecond(result.m_Stats.m_nGenerated, dSeconds);
+		out << ",\"peak_node_bytes\":" << nNodeBytes << ",\"peak_search_bytes\":" << nSearchBytes << ",\"stats\":" << getSearchStatsJson(result.m_Stats) << "}\n";
+
+		summary.m_nRuns++;
+		if (nMoves == instance.m_nDepth)
+			summary.m_nOptimal++;
+		summary.m_dSeconds += dSeconds;
+		summary.m_nPeakNodeBytes = max(summary.m_nPeakNodeBytes, nNodeBytes);
+		summary.m_nPeakSearchBytes = max(summary.m_nPeakSearchBytes, nSearchBytes);
+		addSearchStats(summary.m_Stats, result.m_Stats);
+	}
+
+	out << "{\"alg\":\"" << strAlgorithm << "\",\"set\":\"summary\",\"runs\":" << summary.m_nRuns << ",\"optimal\":" << summary.m_nOptimal;
+	out << ",\"seconds\":" << summary.m_dSeconds << ",\"nodes_per_sec\":" << getNodesPerSecond(summary.m_Stats.m_nGenerated, summary.m_dSeconds);
+	out << ",\"peak_node_bytes\":" << summary.m_nPeakNodeBytes << ",\"peak_search_bytes\":" << summary.m_nPeakSearchBytes << ",\"stats\":" << getSearchStatsJson(summary.m_Stats) << "}\n";
+	out.flush();
+}
+
+//Writes one object per heuristic and SIMD level with the fastest of nRepeat passes.
+//"matches" is false if any value differs from the scalar tables.
+void runHeuristicBenchmark(PackedState goal, int nRepeat, ostream &out)
+{
+	int nParity = getStateParity(goal);
+	vector<PackedState> vStates(NUM_STATE_RANKS);
+	for (int rank = 0; rank < NUM_STATE_RANKS; rank++)
+		vStates[rank] = unrankState(rank, nParity);
+
+	HeuristicType types[] = { H_MANHATTAN, H_MISPLACED };
+	const char* chTypes[] = { "manhattan", "toop" };
+	vector<int> vExpected(vStates.size());
+	vector<int> vValues(vStates.size());
+	for (int t = 0; t < 2; t++)
+	{
+		BatchTileHeuristic kernel;
+		kernel.build(goal, types[t]);
+		kernel.setSimdLevel(SIMD_SCALAR);
+		kernel.evaluate(&vStates[0], vStates.size(), &vExpected[0]);
+		for (int level = SIMD_SCALAR; level <= getSupportedSimdLevel(); level++)
+		{
+			kernel.setSimdLevel((SimdLevel)level);
+			double dSeconds = 0;
+			for (int r = 0; r < nRepeat; r++)
+			{
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				kernel.evaluate(&vStates[0], vStates.size(), &vValues[0]);
+				double dRun = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+				if (r == 0 || dRun < dSeconds)
+					dSeconds = dRun;
+			}
+			out << "{\"heuristic\":\"" << chTypes[t] << "\",\"simd\":\"" << getSimdLevelName((SimdLevel)level) << "\",\"states\":" << vStates.size();
+			out << ",\"seconds\":" << dSeconds << ",\"states_per_sec\":" << getNodesPerSecond(vStates.size(), dSeconds);
+			out << ",\"matches\":" << (vValues == vExpected ? "true" : "false") << "}\n";
+		}
+	}
+	out.flush();
+}
+
+//benchmark.exe [--alg NAME[,NAME...]] [--per-depth K] [--seed S] [--repeat R] [--timers] [--heuristics] [--out FILE]
+int main(int argc, char* argv[])
+{
+	vector<string> vAlgorithms(g_chAlgorithms, g_chAlgorithms + sizeof(g_chAlgorithms) / sizeof(g_chAlgorithms[0]));
+	int nPerDepth = 3;
+	unsigned int nSeed = 2016;
+	int nRepeat = 1;
+	bool bTimers = false;
+	bool bHeuristics = false;
+	string strOut;
+	for (int i = 1; i < argc; i++)
+	{
+		string strArg = argv[i];
+		if (strArg == "--alg" && i + 1 < argc)
+		{
+			vAlgorithms.clear();
+			string strList = argv[++i];
+			size_t nStart = 0;
+			while (nStart <= strList.size())
+			{
+				size_t nEnd = strList.find(',', nStart);
+				if (nEnd == string::npos)
+					nEnd = strList.size();
+				vAlgorithms.push_back(strList.substr(nStart, nEnd - nStart));
+				nStart = nEnd + 1;
+			}
+		}
+		else if (strArg == "--per-depth" && i + 1 < argc)
+			nPerDepth = atoi(argv[++i]);
+		else if (strArg == "--seed" && i + 1 < argc)
+			nSeed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		else if (strArg == "--repeat" && i + 1 < argc)
+			nRepeat = max(1, atoi(argv[++i]));
+		else if (strArg == "--timers")
+			bTimers = true;
+		else if (strArg == "--heuristics")
+			bHeuristics = true;
+		else if (strArg == "--out" && i + 1 < argc)
+			strOut = argv[++i];
+		else
+		{
+			cerr << "Usage: benchmark.exe [--alg NAME[,NAME...]] [--per-depth K] [--seed S] [--repeat R] [--timers] [--heuristics] [--out FILE]\n";
+			return 1;
+		}
+	}
+
+	vector<SolverAlgorithm> vSolvers(vAlgorithms.size());
+	for (unsigned int i = 0; i < vAlgorithms.size(); i++)
+	{
+		if (!getSolverAlgorithm(vAlgorithms[i], vSolvers[i]) || vSolvers[i].m_Heuristic == H_PATTERN_DB)
+		{
+			cerr << "Unknown algorithm " << vAlgorithms[i] << ".\n";
+			return 1;
+		}
+	}
+
+	PackedState goal;
+	parseStateString(BENCH_GOAL, goal);
+	vector<BenchInstance> vCorpus;
+	if (!buildBenchCorpus(goal, nPerDepth, nSeed, vCorpus))
+	{
+		cerr << "Could not open or generate the distance database.\n";
+		return 1;
+	}
+
+	ofstream file;
+	if (!strOut.empty())
+	{
+		file.open(strOut.c_str());
+		if (!file)
+		{
+			cerr << "Could not open " << strOut << ".\n";
+			return 1;
+		}
+	}
+	ostream &out = strOut.empty() ? cout : file;
+	for (unsigned int i = 0; i < vAlgorithms.size(); i++)
+		runBenchmark(vAlgorithms[i], vSolvers[i], goal, vCorpus, nRepeat, bTimers, out);
+	if (bHeuristics)
+		runHeuristicBenchmark(goal, nRepeat, out);
+	return 0;
+}
@@ -0,0 +1,284 @@
+/////////////////////////////////////////////////////////////
+// Bidirectional searches for eight_tile_solver.
+//
+// Searches forward from the start and backward from the goal at once, each
+// side keeping its reached states in its own hashed set (see visited_set.h),
+// and stops once the two meet. Each side only has to reach about half the
+// solution depth, so far fewer nodes are generated than in a one-way search.
+// Every move is its own inverse, so the backward search simply slides tiles
+// from the goal, and its half of the path is spliced on by undoing its moves
+// in reverse order.
+//  solveBidirectionalBFS expands whole layers, always on the smaller side.
+//  solveBidirectionalAStar is front-to-end: each side is an A* toward the
+//  other side's root, and the search stops when the best meeting found is no
+//  longer than the smallest f on either open list.
+// Both return optimal solutions. Does no console output.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <limits.h>
+#include "packed_state.h"
+#include "node.h"
+#include "node_pool.h"
+#include "visited_set.h"
+#include "state_rank.h"
+#include "heuristics.h"
+#include "search_stats.h"
+#include "bucket_queue.h"
+#include "move_string.h"
+
+using namespace std;
+
+bool solveBidirectionalBFS(PackedState start, PackedState goal, NodePool &pool, VisitedSet &forward, VisitedSet &backward, MoveString &path, SearchStats &stats); //Returns false if unsolvable
+bool solveBidirectionalAStar(PackedState start, PackedState goal, Heuristic &toGoal, Heuristic &toStart, NodePool &pool, VisitedSet &forward, VisitedSet &backward, MoveString &path, SearchStats &stats); //Returns false if unsolvable
+void spliceBidirectionalPath(Node *pForward, Node *pBackward, MoveString &path); //Joins the two halves of a path meeting at one state
+
+//Bidirectional breadth first search. Each round expands every node of one side's
+//current layer, choosing the side with the smaller layer. Nodes are added to their
+//side's set when generated and looked up in the other side's set; the shortest of
+//all meetings in the layer where the sides first meet is optimal.
+bool solveBidirectionalBFS(PackedState start, PackedState goal, NodePool &pool, VisitedSet &forward, VisitedSet &backward, MoveString &path, SearchStats &stats)
+{
+	path.clear();
+	clearSearchStats(stats);
+	if (getStateParity(start) != getStateParity(goal))
+		return false; //the sides would never meet
+	if (start == goal)
+		return true;
+
+	pool.releaseAll();
+	forward.clear();
+	backward.clear();
+	Node* pStart = pool.createNode(start);
+	Node* pGoal = pool.createNode(goal);
+	forward.insert(start, pStart);
+	backward.insert(goal, pGoal);
+	vector<Node*> vForwardLayer(1, pStart);
+	vector<Node*> vBackwardLayer(1, pGoal);
+	vector<Node*> vNext;
+
+	while (!vForwardLayer.empty() && !vBackwardLayer.empty())
+	{
+		bool bForward = vForwardLayer.size() <= vBackwardLayer.size();
+		vector<Node*> &vLayer = bForward ? vForwardLayer : vBackwardLayer;
+		VisitedSet &own = bForward ? forward : backward;
+		VisitedSet &other = bForward ? backward : forward;
+
+		Node* pMeetOwn = nullptr;
+		Node* pMeetOther = nullptr;
+		int nBestLength = INT_MAX;
+		vNext.clear();
+		for (unsigned int i = 0; i < vLayer.size(); i++)
+		{
+			Node* node = vLayer[i];
+			PackedState state = node->getState();
+			stats.m_nExpanded++;
+			const PackedMoves &moves = getPackedMoves(state);
+			for (int m = 0; m < moves.m_nCount; m++)
+			{
+				//Skip the move back to the parent
+				int move = moves.m_nMoves[m];
+				if (move == (node->getAction() ^ 1))
+					continue;
+				PackedState childState = slidePackedTile(state, move);
+				stats.m_nGenerated++;
+				Node* pMeet;
+				{
+					PhaseTimer timer(stats, PHASE_DUPLICATE);
+					if (own.contains(childState))
+					{
+						stats.m_nDuplicates++;
+						continue;
+					}
+					pMeet = other.find(childState);
+				}
+
+				Node* child;
+				{
+					PhaseTimer timer(stats, PHASE_EXPAND);
+					child = pool.createNode(state, move, node);
+				}
+				{
+					PhaseTimer timer(stats, PHASE_DUPLICATE);
+					own.insert(childState, child);
+				}
+				vNext.push_back(child);
+
+				if (pMeet != nullptr && child->getDepth() + pMeet->getDepth() < nBestLength)
+				{
+					nBestLength = child->getDepth() + pMeet->getDepth();
+					pMeetOwn = child;
+					pMeetOther = pMeet;
+				}
+			}
+		}
+
+		updateSearchPeak(stats.m_nPeakOpen, vNext.size() + (bForward ? vBackwardLayer.size() : vForwardLayer.size()));
+		updateSearchPeak(stats.m_nPeakClosed, forward.getSize() + backward.getSize());
+		if (pMeetOwn != nullptr)
+		{
+			if (bForward)
+				spliceBidirectionalPath(pMeetOwn, pMeetOther, path);
+			else
+				spliceBidirectionalPath(pMeetOther, pMeetOwn, path);
+			return true;
+		}
+		vLayer.swap(vNext);
+	}
+	return false;
+}
+
+//Front-to-end bidirectional A*. The forward side orders nodes by g + h toward the goal
+//(toGoal), the backward side by g + h toward the start (toStart), and each round expands
+//the best node of the side with the smaller open list. A* re-opens and lazy deletion
+//work as in solveBestFirst. Whenever a node is generated that the other side has
+//reached, the meeting's length is a candidate solution. Every open list holds a node
+//of an optimal path with its optimal g, so once the best candidate is no longer than
+//the smaller f on either side no shorter path can remain.
+bool solveBidirectionalAStar(PackedState start, PackedState goal, Heuristic &toGoal, Heuristic &toStart, NodePool &pool, VisitedSet &forward, VisitedSet &backward, MoveString &path, SearchStats &stats)
+{
+	path.clear();
+	clearSearchStats(stats);
+	if (getStateParity(start) != getStateParity(goal))
+		return false; //the sides would never meet
+	if (start == goal)
+		return true;
+
+	pool.releaseAll();
+	forward.clear();
+	backward.clear();
+	BucketQueue<Node*> qForwardOpen;	//by f, then deepest first
+	BucketQueue<Node*> qBackwardOpen;
+
+	//Roots. Total cost is f = g + h, with g = depth - 1
+	uint32_t nKey;
+	Node* pStart = pool.createNode(start);
+	int h = toGoal.evaluate(start, nKey);
+	stats.m_nHeuristicEvaluations += 2;
+	pStart->setHeuristic(h, nKey);
+	pStart->setTotalCost(h);
+	Node* pGoal = pool.createNode(goal);
+	h = toStart.evaluate(goal, nKey);
+	pGoal->setHeuristic(h, nKey);
+	pGoal->setTotalCost(h);
+	forward.insert(start, pStart);
+	backward.insert(goal, pGoal);
+	qForwardOpen.push(pStart, pStart->getTotalCost(), 0);
+	qBackwardOpen.push(pGoal, pGoal->getTotalCost(), 0);
+
+	Node* pMeetForward = nullptr;
+	Node* pMeetBackward = nullptr;
+	int nBestLength = INT_MAX; //moves in the best meeting found so far
+
+	while (true)
+	{
+		//Drop nodes superseded by a cheaper path to the same state (lazy deletion)
+		while (!qForwardOpen.empty() && forward.find(qForwardOpen.top()->getState()) != qForwardOpen.top())
+			qForwardOpen.pop();
+		while (!qBackwardOpen.empty() && backward.find(qBackwardOpen.top()->getState()) != qBackwardOpen.top())
+			qBackwardOpen.pop();
+		if (qForwardOpen.empty() || qBackwardOpen.empty())
+			break; //one side is exhausted, so every meeting has been seen
+		if (nBestLength <= max(qForwardOpen.getTopPriority(), qBackwardOpen.getTopPriority()))
+			break;
+
+		bool bForward = qForwardOpen.size() <= qBackwardOpen.size();
+		BucketQueue<Node*> &qOpen = bForward ? qForwardOpen : qBackwardOpen;
+		VisitedSet &own = bForward ? forward : backward;
+		VisitedSet &other = bForward ? backward : forward;
+		Heuristic &heuristic = bForward ? toGoal : toStart;
+
+		Node* node;
+		{
+			PhaseTimer timer(stats, PHASE_QUEUE);
+			node = qOpen.top();
+			qOpen.pop();
+		}
+		stats.m_nExpanded++;
+		PackedState state = node->getState();
+		int nChildG = node->getDepth(); //parent's g + 1
+		const PackedMoves &moves = getPackedMoves(state);
+		for (int m = 0; m < moves.m_nCount; m++)
+		{
+			//Skip states this side already reached with an equal or cheaper path
+			int move = moves.m_nMoves[m];
+			PackedState childState = slidePackedTile(state, move);
+			stats.m_nGenerated++;
+			Node* pBest;
+			{
+				PhaseTimer timer(stats, PHASE_DUPLICATE);
+				pBest = own.find(childState);
+			}
+			if (pBest != nullptr && pBest->getDepth() - 1 <= nChildG)
+			{
+				stats.m_nDuplicates++;
+				continue;
+			}
+
+			Node* child;
+			{
+				PhaseTimer timer(stats, PHASE_EXPAND);
+				child = pool.createNode(state, move, node);
+			}
+			uint32_t nChildKey = node->getHeuristicKey();
+			int nChildH;
+			{
+				PhaseTimer timer(stats, PHASE_HEURISTIC);
+				nChildH = heuristic.getChildValue(state, node->getHeuristic(), nChildKey, childState);
+			}
+			stats.m_nHeuristicEvaluations++;
+			child->setHeuristic(nChildH, nChildKey);
+			child->setTotalCost(nChildG + nChildH);
+			Node* pMeet;
+			{
+				PhaseTimer timer(stats, PHASE_DUPLICATE);
+				if (pBest == nullptr)
+					own.insert(childState, child);
+				else
+				{
+					own.replace(childState, child); //re-open with the cheaper path
+					stats.m_nReopened++;
+				}
+				pMeet = other.find(childState);
+			}
+			{
+				PhaseTimer timer(stats, PHASE_QUEUE);
+				qOpen.push(child, nChildG + nChildH, nChildG);
+			}
+			updateSearchPeak(stats.m_nPeakOpen, qForwardOpen.size() + qBackwardOpen.size());
+
+			//Candidate solution through the other side's best path to this state
+			if (pMeet != nullptr && nChildG + pMeet->getDepth() - 1 < nBestLength)
+			{
+				nBestLength = nChildG + pMeet->getDepth() - 1;
+				pMeetForward = bForward ? child : pMeet;
+				pMeetBackward = bForward ? pMeet : child;
+			}
+		}
+	}
+
+	stats.m_nPeakClosed = forward.getSize() + backward.getSize();
+	if (pMeetForward == nullptr)
+		return false;
+	spliceBidirectionalPath(pMeetForward, pMeetBackward, path);
+	return true;
+}
+
+//pForward was reached from the start and pBackward from the goal, and both hold the
+//same state. The forward moves are kept as they are; the backward moves, which lead
+//from the goal to the meeting, are undone in reverse order to lead on to the goal.
+void spliceBidirectionalPath(Node *pForward, Node *pBackward, MoveString &path)
+{
+	path.clear();
+	path.resize(pForward->getDepth() - 1);
+	size_t i = path.size();
+	for (Node* node = pForward; i > 0; node = node->getParent())
+		path.set(--i, node->getAction());
+	for (Node* node = pBackward; node->getParent() != nullptr; node = node->getParent())
+		path.push_back(node->getAction() ^ 1); //[0]<->[1], [2]<->[3]
+}
@@ -12,6 +12,9 @@
 #include <Windows.h>
 #include <regex>
 #include <math.h>
+#include "packed_state.h"
+#include "state_rank.h"
+#include "instance_generator.h"
 
 using namespace std;
 
@@ -341,20 +344,15 @@ bool isMoveLegal(int board[3][3], int move, int boardsize)
 }
 
 //Randomizes board. Leaves goalboard intact, but uses it to ensure our randomized state isn't the solved state.
-//From http://www.cplusplus.com/forum/general/84737/
-void randomizeStateBoard(int board[3][3], int goalboard[3][3], int boardsize)
+//Draws uniformly among the states that can reach the goal (see instance_generator.h), seeded once per run.
+void randomizeStateBoard(int board[3][3], int goalboard[3][3], int /*boardsize*/)
 {
-	time_t t;
-	srand((unsigned)time(&t)); //TODO: MOVE to main
-	int move;
-	while (isBoardSolved(board, goalboard, boardsize)) //If the board ends up being solved at the end of the randomize, randomize the board again
-	{
-		for (int i = 0; i < 100000; i++) //Series of 100000 random moves
-		{
-			move = rand() % 4;
-			slideTile(board, move, boardsize);
-		}
-	}
+	static InstanceGenerator generator((uint64_t)time(nullptr));
+	PackedState goal = packMatrix(goalboard);
+	PackedState state = generator.next(goal);
+	while (state == goal) //If the board drawn is the solved state, draw again
+		state = generator.next(goal);
+	unpackMatrix(state, board);
 }
 
 //Checks board state to see if it is solved
@@ -381,61 +379,16 @@ bool isBoardSolved(int board[3][3], int goalboard[3][3], int boardsize)
 	return boardSolved;
 }
 
-//Do parity check to ensure goal state is reachable from current state:
-//For every int look at each other int to see if it is "greater" than it (i.e. it is out of order)
-bool isBoardSolvable(int board[3][3], int goalboard[3][3], int boardsize)
+//Do parity check to ensure goal state is reachable from current state.
+//Both boards are packed and compared by inversion parity (see getStateParity in state_rank.h)
+bool isBoardSolvable(int board[3][3], int goalboard[3][3], int /*boardsize*/)
 {
-	//Populates linear arrays with the numbers from the matrix, for convenience working with them.
-	int tempGoalState[9];
-	getLinearFromMatrix(goalboard, boardsize, tempGoalState); 
-	int tempStartState[9];
-	getLinearFromMatrix(board, boardsize, tempStartState);
-
-	//For each element, count number of elements which are on right side of it and are smaller than it.
-	int nGoalInvCount = 0;
-	for (int i = 0; i < 8; i++)
-		for (int j = i + 1; j < 9; j++)
-			if (tempGoalState[j] && tempGoalState[i] && tempGoalState[i] > tempGoalState[j])
-				nGoalInvCount++;
-	int nStartInvCount = 0;
-	for (int i = 0; i < 8; i++)
-		for (int j = i + 1; j < 9; j++)
-			if (tempStartState[j] && tempStartState[i] && tempStartState[i] > tempStartState[j])
-				nStartInvCount++;
-
-	//Solvable iff both states have same parity
-	if (nGoalInvCount % 2 == 0 && nStartInvCount % 2 == 0)
-		return true;
-	else if (nGoalInvCount % 2 != 0 && nStartInvCount % 2 != 0)
-		return true;
-
-	return false;
+	return getStateParity(packMatrix(board)) == getStateParity(packMatrix(goalboard));
 }
 
-bool isBoardSolvable(int* board, int* goalboard, int boardsize)
+bool isBoardSolvable(int* board, int* goalboard, int /*boardsize*/)
 {
-	int* tempGoalState = goalboard;
-	int* tempStartState = board;
-
-	//For each element, count number of elements which are on right side of it and are smaller than it.
-	int nGoalInvCount = 0;
-	for (int i = 0; i < 8; i++)
-		for (int j = i + 1; j < 9; j++)
-			if (tempGoalState[j] && tempGoalState[i] && tempGoalState[i] > tempGoalState[j])
-				nGoalInvCount++;
-	int nStartInvCount = 0;
-	for (int i = 0; i < 8; i++)
-		for (int j = i + 1; j < 9; j++)
-			if (tempStartState[j] && tempStartState[i] && tempStartState[i] > tempStartState[j])
-				nStartInvCount++;
-
-	//Solvable iff both states have same parity
-	if (nGoalInvCount % 2 == 0 && nStartInvCount % 2 == 0)
-		return true;
-	else if (nGoalInvCount % 2 != 0 && nStartInvCount % 2 != 0)
-		return true;
-
-	return false;
+	return getStateParity(packState(board)) == getStateParity(packState(goalboard));
 }
 
 //returns an int* of size 8 from a 3zx3 matrix as a linear list.
@@ -484,32 +437,30 @@ int getTilesOutOfOrderHeuristic(int board[3][3], int goalboard[3][3], int boards
 	return nTOOP;
 }
 
+//Sum over all tiles of the rows plus columns between the tile and its goal position.
+//The searches use the precomputed TileDistanceTable (heuristics.h) instead.
 int getManhattanHeuristic(int board[3][3], int goalboard[3][3], int boardsize)
 {
-	//Populates linear arrays with the numbers from the matrix, for convenience working with them.
-	int goalState[9];
-	int currState[9];
-	getLinearFromMatrix(goalboard, boardsize, goalState);
-	getLinearFromMatrix(board, boardsize, currState);
+	//find the row/col of each tile in the goal state
+	int nGoalRow[9];
+	int nGoalCol[9];
+	for (int row = 0; row < boardsize; row++)
+	{
+		for (int column = 0; column < boardsize; column++)
+		{
+			nGoalRow[goalboard[row][column]] = row;
+			nGoalCol[goalboard[row][column]] = column;
+		}
+	}
 
  	int nManhattanDist = 0;
-	for (int x = 0; x < 9; x++)
+	for (int row = 0; row < boardsize; row++)
 	{
-		int nValue = currState[x];
-		if (nValue != 0) // (Skip blank tile)
+		for (int column = 0; column < boardsize; column++)
 		{
-			//find the x/y coords in the goal state for the current val
-			int nGoalX = 0;
-			for (int i = 0; i < 9; i++)
-			{
-				if (goalState[i] == nValue)
-				{
-					nGoalX = i;
-					break;
-				}
-			}
-			int dx = x - nGoalX; // x-distance to goal coordinate
-			nManhattanDist += abs(dx);
+			int nValue = board[row][column];
+			if (nValue != 0) // (Skip blank tile)
+				nManhattanDist += abs(row - nGoalRow[nValue]) + abs(column - nGoalCol[nValue]);
 		}
 	}
 	return nManhattanDist;
@@ -0,0 +1,127 @@
+/////////////////////////////////////////////////////////////
+// Bucketed priority queue for eight_tile_solver.
+//
+// An open list for searches whose priorities are small non-negative integers,
+// such as f = g + h on the sliding puzzles. Items are kept in two levels of
+// buckets, first by priority (lower first) and then by a tie-break value
+// (higher first, ex: g, so among equal f the node nearest the goal is taken
+// and fewer nodes of the last f layer are expanded). Items with the same
+// priority and tie-break are taken last in, first out. Push is O(1); pop is
+// O(1) amortized, since the cursor only moves past buckets that are empty.
+// Bucket memory is kept across clear() so a reused queue stops allocating.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <vector>
+
+using namespace std;
+
+template<class T>
+class BucketQueue
+{
+public:
+	BucketQueue();
+	void push(T item, int nPriority, int nTieBreak);	//nPriority and nTieBreak must be >= 0
+	T top();						//Item of lowest priority, highest tie-break. Queue must not be empty
+	int getTopPriority();			//Priority of top(). Queue must not be empty
+	void pop();
+	bool empty();
+	size_t size();
+	void clear();					//Removes every item, keeping the buckets
+
+protected:
+	void findTop();					//Moves the cursor to the bucket holding top()
+
+	vector< vector< vector<T> > > m_vBuckets;	// [priority][tie-break] = items, the last taken first
+	size_t m_nSize;
+	int m_nTopPriority;				// No item has a lower priority..
+	int m_nTopTie;					// ..or the same priority and a higher tie-break
+};
+
+template<class T>
+BucketQueue<T>::BucketQueue() : m_nSize(0), m_nTopPriority(0), m_nTopTie(0)
+{
+}
+
+//Grows the buckets as needed and moves the cursor back if the item goes before it
+template<class T>
+void BucketQueue<T>::push(T item, int nPriority, int nTieBreak)
+{
+	if (nPriority >= (int)m_vBuckets.size())
+		m_vBuckets.resize(nPriority + 1);
+	vector< vector<T> > &vTies = m_vBuckets[nPriority];
+	if (nTieBreak >= (int)vTies.size())
+		vTies.resize(nTieBreak + 1);
+	vTies[nTieBreak].push_back(item);
+
+	if (m_nSize == 0 || nPriority < m_nTopPriority || (nPriority == m_nTopPriority && nTieBreak > m_nTopTie))
+	{
+		m_nTopPriority = nPriority;
+		m_nTopTie = nTieBreak;
+	}
+	m_nSize++;
+}
+
+//Steps down through the tie-breaks of the cursor's priority, then on to the next priority
+template<class T>
+void BucketQueue<T>::findTop()
+{
+	while (m_vBuckets[m_nTopPriority].empty() || m_vBuckets[m_nTopPriority][m_nTopTie].empty())
+	{
+		if (--m_nTopTie < 0)
+		{
+			m_nTopPriority++;
+			m_nTopTie = (int)m_vBuckets[m_nTopPriority].size() - 1;
+		}
+	}
+}
+
+template<class T>
+T BucketQueue<T>::top()
+{
+	findTop();
+	return m_vBuckets[m_nTopPriority][m_nTopTie].back();
+}
+
+template<class T>
+int BucketQueue<T>::getTopPriority()
+{
+	findTop();
+	return m_nTopPriority;
+}
+
+template<class T>
+void BucketQueue<T>::pop()
+{
+	findTop();
+	m_vBuckets[m_nTopPriority][m_nTopTie].pop_back();
+	m_nSize--;
+}
+
+template<class T>
+bool BucketQueue<T>::empty()
+{
+	return m_nSize == 0;
+}
+
+template<class T>
+size_t BucketQueue<T>::size()
+{
+	return m_nSize;
+}
+
+template<class T>
+void BucketQueue<T>::clear()
+{
+	for (unsigned int p = 0; p < m_vBuckets.size(); p++)
+	{
+		for (unsigned int t = 0; t < m_vBuckets[p].size(); t++)
+			m_vBuckets[p][t].clear();
+	}
+	m_nSize = 0;
+	m_nTopPriority = 0;
+	m_nTopTie = 0;
+}
@@ -0,0 +1,214 @@
+/////////////////////////////////////////////////////////////
+// All-states distance database for eight_tile_solver.
+//
+// A single retrograde BFS from the goal visits every reachable state and
+// records its optimal distance to the goal, one byte per state rank (see
+// state_rank.h), about 177 KB in all. The table is written to a file the
+// first time a goal is used and memory mapped from then on; a file that is
+// stale, truncated or from another version is deleted and rebuilt. A query then
+// walks greedily downhill through the table: each step picks the neighbor
+// one move closer to the goal, giving an optimal solution with no search.
+//
+// File layout: DatabaseHeader, followed by NUM_STATE_RANKS distance bytes.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "packed_state.h"
+#include "state_rank.h"
+#include "mapped_file.h"
+#include "parallel_bfs.h"
+#include "move_string.h"
+
+using namespace std;
+
+#define DB_MAGIC "8TDB"
+#define DB_VERSION 1
+#define DB_UNREACHED BFS_UNREACHED
+
+struct DatabaseHeader
+{
+	char m_chMagic[4];		// DB_MAGIC
+	uint32_t m_nVersion;	// DB_VERSION
+	uint64_t m_nGoalTiles;	// Packed goal state the distances are measured to
+};
+
+string getDistanceDatabaseName(PackedState goal); //Returns the file name used for goal's table (ex: eight_tile_123456780.db)
+bool buildDistanceDatabase(PackedState goal, string path, unsigned int nThreads = 0); //Runs the retrograde BFS from goal and writes the table to path, through a temp file
+
+class DistanceDatabase
+{
+public:
+	DistanceDatabase();
+	bool open(PackedState goal, string directory = "");	//Maps goal's table, generating the file first if needed
+	bool isOpen();
+	PackedState getGoal();
+	int getDistance(PackedState state);					//Optimal number of moves to the goal, -1 if unreachable
+	bool solve(PackedState start, MoveString &path);	//Fills path with an optimal solution. Returns false if unreachable or the table is corrupt
+	void getRanksByDepth(vector< vector<int> > &vRanksByDepth);	//[depth] = ranks (see state_rank.h) of the goal's parity class that far from the goal
+
+protected:
+	bool mapFile(string path, PackedState goal);		//Maps path if its header and size match goal's table
+
+	MappedFile m_File;
+	const unsigned char* m_pDistances;	// Points just past the header in the mapping
+	PackedState m_Goal;
+	int m_nParity;						// Parity class of the goal; other states are unreachable
+};
+
+//Returns the file name used for goal's table, built from the goal's digits
+string getDistanceDatabaseName(PackedState goal)
+{
+	string strName = "eight_tile_";
+	for (int i = 0; i < 9; i++)
+		strName += (char)('0' + getPackedTile(goal, i));
+	return strName + ".db";
+}
+
+//Breadth first search outward from goal over state ranks, one layer per depth,
+//spread over nThreads threads (see parallel_bfs.h). Every state's distance is its
+//BFS depth, since each move is its own inverse.
+bool buildDistanceDatabase(PackedState goal, string path, unsigned int nThreads)
+{
+	vector<unsigned char> vDistances;
+	vector<unsigned int> vLayerSizes;
+	runParallelBFS(goal, nThreads, vDistances, vLayerSizes);
+
+	DatabaseHeader header;
+	memcpy(header.m_chMagic, DB_MAGIC, 4);
+	header.m_nVersion = DB_VERSION;
+	header.m_nGoalTiles = goal.m_nTiles;
+
+	string strTemp = getTempFilePath(path);
+	ofstream file(strTemp.c_str(), ios::binary | ios::trunc);
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)&vDistances[0], vDistances.size());
+	file.close();
+	if (!file.good() || !replaceFile(strTemp, path))
+	{
+		deleteFile(strTemp);
+		return false;
+	}
+	return true;
+}
+
+//Constructor
+DistanceDatabase::DistanceDatabase() : m_pDistances(nullptr), m_nParity(0)
+{
+	m_Goal.m_nTiles = 0;
+	m_Goal.m_nBlank = 0;
+}
+
+//Maps goal's table from directory (which, if given, must end in a path separator).
+//The file is generated on first use, and replaced if it is invalid. Returns false if it can't be built.
+bool DistanceDatabase::open(PackedState goal, string directory)
+{
+	string strPath = directory + getDistanceDatabaseName(goal);
+	m_pDistances = nullptr;
+	if (!mapFile(strPath, goal))
+	{
+		deleteFile(strPath);
+		if (!buildDistanceDatabase(goal, strPath) || !mapFile(strPath, goal))
+			return false;
+	}
+
+	m_pDistances = m_File.getData() + sizeof(DatabaseHeader);
+	m_Goal = goal;
+	m_nParity = getStateParity(goal);
+	return true;
+}
+
+//Validates the header so a stale or truncated file is never trusted
+bool DistanceDatabase::mapFile(string path, PackedState goal)
+{
+	if (!m_File.open(path))
+		return false;
+	const DatabaseHeader* pHeader = (const DatabaseHeader*)m_File.getData();
+	if (m_File.getSize() != sizeof(DatabaseHeader) + NUM_STATE_RANKS || memcmp(pHeader->m_chMagic, DB_MAGIC, 4) != 0
+		|| pHeader->m_nVersion != DB_VERSION || pHeader->m_nGoalTiles != goal.m_nTiles)
+	{
+		m_File.close();
+		return false;
+	}
+	return true;
+}
+
+bool DistanceDatabase::isOpen()
+{
+	return m_pDistances != nullptr;
+}
+
+PackedState DistanceDatabase::getGoal()
+{
+	return m_Goal;
+}
+
+//Optimal number of moves from state to the goal, -1 if state is unreachable
+int DistanceDatabase::getDistance(PackedState state)
+{
+	if (getStateParity(state) != m_nParity)
+		return -1;
+	return m_pDistances[rankState(state)];
+}
+
+//Walks downhill through the table from start: every state except the goal has
+//a neighbor exactly one move closer, so the walk takes getDistance(start) steps.
+//Only the header of a mapped file is checked, so a step with no neighbor one move
+//closer, or a walk that ends off the goal, means the distances are corrupt.
+bool DistanceDatabase::solve(PackedState start, MoveString &path)
+{
+	path.clear();
+	int nDistance = getDistance(start);
+	if (nDistance < 0 || nDistance == DB_UNREACHED)
+		return false;
+
+	PackedState state = start;
+	while (nDistance > 0)
+	{
+		bool bDownhill = false;
+		const PackedMoves &moves = getPackedMoves(state);
+		for (int m = 0; m < moves.m_nCount && !bDownhill; m++)
+		{
+			int move = moves.m_nMoves[m];
+			PackedState child = slidePackedTile(state, move);
+			if (m_pDistances[rankState(child)] == nDistance - 1)
+			{
+				path.push_back(move);
+				state = child;
+				nDistance--;
+				bDownhill = true;
+			}
+		}
+		if (!bDownhill)
+		{
+			path.clear();
+			return false;
+		}
+	}
+	if (state != m_Goal)
+	{
+		path.clear();
+		return false;
+	}
+	return true;
+}
+
+//One pass over the table, in rank order, so each depth's ranks come out sorted
+void DistanceDatabase::getRanksByDepth(vector< vector<int> > &vRanksByDepth)
+{
+	vRanksByDepth.clear();
+	for (int rank = 0; rank < NUM_STATE_RANKS; rank++)
+	{
+		int nDepth = m_pDistances[rank];
+		if (nDepth >= (int)vRanksByDepth.size())
+			vRanksByDepth.resize(nDepth + 1);
+		vRanksByDepth[nDepth].push_back(rank);
+	}
+}
@@ -10,11 +10,29 @@
 #include <Windows.h>
 #include "board.h"
 #include "search_algs.h"
+#include "batch_solver.h"
 
 using namespace std;
 
-int main()
+int main(int argc, char* argv[])
 {
+	//eight_tile.exe --batch ... solves puzzles from a file or stdin with no prompts, and
+	//eight_tile.exe --bfs ... runs a parallel BFS over the state space, and
+	//eight_tile.exe --generate ... writes random puzzles (see batch_solver.h)
+	if (argc > 1 && string(argv[1]) == "--batch")
+		return doBatchMode(argc, argv);
+	if (argc > 1 && string(argv[1]) == "--bfs")
+		return doLayerMode(argc, argv);
+	if (argc > 1 && string(argv[1]) == "--generate")
+		return doGenerateMode(argc, argv);
+
+	//eight_tile.exe --no-boards prints solutions as a line of moves instead of drawing every board
+	for (int i = 1; i < argc; i++)
+	{
+		if (string(argv[i]) == "--no-boards")
+			g_bShowBoards = false;
+	}
+
 	char chUserInput = ' ';
 	int nBoardSize = 3 ; //nBoardSize = size of board aligned with nth index, so we can use it as an index for array stateboard
 	int stateboard[3][3]; // Current state
@@ -82,6 +100,12 @@ int main()
 		string strAlgTwo = "Greedy Best-First-Search (Manahattan Distance heuristic)";
 		string strAlgThree = "A* (Misplaced Tile heuristic)";
 		string strAlgFour = "A* (Manhattan Distance heuristic)";
+		string strAlgFive = "Distance Database (precomputed optimal, no search)";
+		string strAlgSix = "IDA* (Manhattan Distance heuristic)";
+		string strAlgSeven = "A* (Linear Conflict heuristic)";
+		string strAlgEight = "IDA* (Walking Distance heuristic)";
+		string strAlgNine = "Bidirectional Breadth-First-Search";
+		string strAlgZero = "Bidirectional A* (Manhattan Distance heuristic)";
 		string strAlgChosen = "";
 
 		while (true)
@@ -89,6 +113,9 @@ int main()
 			cout << "Puzzle is solvable. Select a search algorithm to solve:\n";
 			cout << "   1. " + strAlgOne + "\n   2. " + strAlgTwo + "\n";
 			cout << "   3. " + strAlgThree + "\n   4. " + strAlgFour + "\n";
+			cout << "   5. " + strAlgFive + "\n   6. " + strAlgSix + "\n";
+			cout << "   7. " + strAlgSeven + "\n   8. " + strAlgEight + "\n";
+			cout << "   9. " + strAlgNine + "\n   0. " + strAlgZero + "\n";
 			chUserInput = _getch();
 
 			if (chUserInput == '1')
@@ -115,6 +142,42 @@ int main()
 					cout << "There was an error solving this puzzle. Check your input and try again.";
 				break;
 			}
+			if (chUserInput == '5')
+			{
+				if (!doDatabaseSearch(stateboard, goalboard))
+					cout << "Error solving this puzzle. Check your input and try again.";
+				break;
+			}
+			if (chUserInput == '6')
+			{
+				if (!doIDAStarSearch(stateboard, goalboard, "Manhattan"))
+					cout << "Error solving this puzzle. Check your input and try again.";
+				break;
+			}
+			if (chUserInput == '7')
+			{
+				if (!doOtherSearch(stateboard, goalboard, nBoardSize, "A* Linear Conflict"))
+					cout << "Error solving this puzzle. Check your input and try again.";
+				break;
+			}
+			if (chUserInput == '8')
+			{
+				if (!doIDAStarSearch(stateboard, goalboard, "Walking Distance"))
+					cout << "Error solving this puzzle. Check your input and try again.";
+				break;
+			}
+			if (chUserInput == '9')
+			{
+				if (!doBidirectionalSearch(stateboard, goalboard, "BFS"))
+					cout << "Error solving this puzzle. Check your input and try again.";
+				break;
+			}
+			if (chUserInput == '0')
+			{
+				if (!doBidirectionalSearch(stateboard, goalboard, "A* Manhattan"))
+					cout << "Error solving this puzzle. Check your input and try again.";
+				break;
+			}
 
 		}
 			
@@ -0,0 +1,201 @@
+/////////////////////////////////////////////////////////////
+// Goal canonicalization for eight_tile_solver.
+//
+// Tile numbers are only names, and the board looks the same after any of its
+// 8 rotations and reflections, so a puzzle (start, goal) can be turned into an
+// equivalent one (start', canonical goal) by moving every position through one
+// of those symmetries and renaming every tile. The canonical goal holds the
+// tiles 1, 2, ... in reading order around the blank, and the symmetry is picked
+// to put the goal's blank on the last position of its orbit, so every goal
+// maps to one canonical goal per orbit of the blank. 3x3 and 4x4 boards have
+// three orbits: corners, edges and center squares (123456780, 123456708 and
+// 123405678 on 3x3). 5x5 boards have six: corners, edge squares next to a
+// corner, edge middles, inner diagonal squares, inner edge squares and the
+// center. Tables built for those goals, such as distance and pattern
+// databases or heuristic caches, then serve every goal. A solution for
+// start' maps back move by move, since a symmetry turns each direction into
+// a fixed other direction.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include "packed_state.h"
+#include "nxn_board.h"
+#include "move_string.h"
+#include <vector>
+
+using namespace std;
+
+#define NUM_SYMMETRIES 8	// Rotations and reflections of a square
+
+template<int N>
+struct GoalCanonicalizer
+{
+	int m_nGoal[N * N];				// Goal tiles the mapping was built for
+	int m_nCanonicalGoal[N * N];
+	int m_nPosition[N * N];			// [position] = position after the symmetry
+	int m_nTile[N * N];				// [tile] = its canonical name. The blank stays 0
+	int m_nMove[4];					// [canonical move] = the same move on the original board
+};
+
+template<int N> void buildGoalCanonicalizer(const int nGoal[N * N], GoalCanonicalizer<N> &canon); //Picks the symmetry and names for goal
+template<int N> bool isCanonicalizerFor(const GoalCanonicalizer<N> &canon, const int nGoal[N * N]); //True if canon was built for goal
+template<int N> void canonicalizeTiles(const GoalCanonicalizer<N> &canon, const int nTiles[N * N], int nCanonical[N * N]);
+template<int N> void restoreMoves(const GoalCanonicalizer<N> &canon, MoveString &path); //Maps a canonical solution back to the original board
+template<int N> int getSymmetricPosition(int nSymmetry, int position); //Position after symmetry 0..7
+void buildGoalCanonicalizer(PackedState goal, GoalCanonicalizer<3> &canon);
+PackedState canonicalizeState(const GoalCanonicalizer<3> &canon, PackedState state);
+PackedState getCanonicalGoal(const GoalCanonicalizer<3> &canon);
+template<int N> void buildGoalCanonicalizer(const BoardState<N> &goal, GoalCanonicalizer<N> &canon);
+template<int N> BoardState<N> canonicalizeBoard(const GoalCanonicalizer<N> &canon, const BoardState<N> &state);
+template<int N> BoardState<N> getCanonicalBoardGoal(const GoalCanonicalizer<N> &canon);
+
+//Symmetry bits: [4] transposes, then [1] flips the rows and [2] the columns
+template<int N>
+int getSymmetricPosition(int nSymmetry, int position)
+{
+	int nRow = position / N;
+	int nCol = position % N;
+	if (nSymmetry & 4)
+	{
+		int nTemp = nRow;
+		nRow = nCol;
+		nCol = nTemp;
+	}
+	if (nSymmetry & 1)
+		nRow = N - 1 - nRow;
+	if (nSymmetry & 2)
+		nCol = N - 1 - nCol;
+	return nRow * N + nCol;
+}
+
+template<int N>
+void buildGoalCanonicalizer(const int nGoal[N * N], GoalCanonicalizer<N> &canon)
+{
+	int nBlank = 0;
+	for (int p = 0; p < N * N; p++)
+	{
+		canon.m_nGoal[p] = nGoal[p];
+		if (nGoal[p] == 0)
+			nBlank = p;
+	}
+
+	//The symmetry taking the blank furthest along in reading order; the first such one wins
+	int nSymmetry = 0;
+	for (int s = 1; s < NUM_SYMMETRIES; s++)
+	{
+		if (getSymmetricPosition<N>(s, nBlank) > getSymmetricPosition<N>(nSymmetry, nBlank))
+			nSymmetry = s;
+	}
+	int nCanonicalBlank = getSymmetricPosition<N>(nSymmetry, nBlank);
+	for (int p = 0, nTile = 1; p < N * N; p++)
+		canon.m_nCanonicalGoal[p] = (p == nCanonicalBlank) ? 0 : nTile++;
+
+	//Each goal tile is named for the canonical goal tile at its new position
+	for (int p = 0; p < N * N; p++)
+	{
+		canon.m_nPosition[p] = getSymmetricPosition<N>(nSymmetry, p);
+		canon.m_nTile[nGoal[p]] = canon.m_nCanonicalGoal[canon.m_nPosition[p]];
+	}
+
+	//Directions as the (row, column) step from the blank to the tile that slides in,
+	//undone through the symmetry in reverse order
+	const int nStep[4][2] = { { 0, 1 }, { 0, -1 }, { 1, 0 }, { -1, 0 } };
+	for (int move = 0; move < 4; move++)
+	{
+		int nRows = nStep[move][0];
+		int nCols = nStep[move][1];
+		if (nSymmetry & 2)
+			nCols = -nCols;
+		if (nSymmetry & 1)
+			nRows = -nRows;
+		if (nSymmetry & 4)
+		{
+			int nTemp = nRows;
+			nRows = nCols;
+			nCols = nTemp;
+		}
+		for (int original = 0; original < 4; original++)
+		{
+			if (nStep[original][0] == nRows && nStep[original][1] == nCols)
+				canon.m_nMove[move] = original;
+		}
+	}
+}
+
+template<int N>
+bool isCanonicalizerFor(const GoalCanonicalizer<N> &canon, const int nGoal[N * N])
+{
+	for (int p = 0; p < N * N; p++)
+	{
+		if (canon.m_nGoal[p] != nGoal[p])
+			return false;
+	}
+	return true;
+}
+
+template<int N>
+void canonicalizeTiles(const GoalCanonicalizer<N> &canon, const int nTiles[N * N], int nCanonical[N * N])
+{
+	for (int p = 0; p < N * N; p++)
+		nCanonical[canon.m_nPosition[p]] = canon.m_nTile[nTiles[p]];
+}
+
+template<int N>
+void restoreMoves(const GoalCanonicalizer<N> &canon, MoveString &path)
+{
+	for (unsigned int i = 0; i < path.size(); i++)
+		path.set(i, canon.m_nMove[path[i]]);
+}
+
+//3x3 packed states
+void buildGoalCanonicalizer(PackedState goal, GoalCanonicalizer<3> &canon)
+{
+	int nGoal[9];
+	unpackState(goal, nGoal);
+	buildGoalCanonicalizer<3>(nGoal, canon);
+}
+
+PackedState canonicalizeState(const GoalCanonicalizer<3> &canon, PackedState state)
+{
+	int nTiles[9];
+	int nCanonical[9];
+	unpackState(state, nTiles);
+	canonicalizeTiles<3>(canon, nTiles, nCanonical);
+	return packState(nCanonical);
+}
+
+PackedState getCanonicalGoal(const GoalCanonicalizer<3> &canon)
+{
+	int nGoal[9];
+	for (int p = 0; p < 9; p++)
+		nGoal[p] = canon.m_nCanonicalGoal[p];
+	return packState(nGoal);
+}
+
+//NxN board states
+template<int N>
+void buildGoalCanonicalizer(const BoardState<N> &goal, GoalCanonicalizer<N> &canon)
+{
+	int nGoal[N * N];
+	unpackBoard(goal, nGoal);
+	buildGoalCanonicalizer<N>(nGoal, canon);
+}
+
+template<int N>
+BoardState<N> canonicalizeBoard(const GoalCanonicalizer<N> &canon, const BoardState<N> &state)
+{
+	int nTiles[N * N];
+	int nCanonical[N * N];
+	unpackBoard(state, nTiles);
+	canonicalizeTiles<N>(canon, nTiles, nCanonical);
+	return packBoard<N>(nCanonical);
+}
+
+template<int N>
+BoardState<N> getCanonicalBoardGoal(const GoalCanonicalizer<N> &canon)
+{
+	return packBoard<N>(canon.m_nCanonicalGoal);
+}
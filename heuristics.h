@@ -0,0 +1,493 @@
+/////////////////////////////////////////////////////////////
+// Table-driven heuristics for eight_tile_solver.
+//
+// Manhattan distance and tiles-out-of-place are both sums of a per-tile cost
+// that depends only on the tile and the position it occupies. The cost of
+// every [tile][position] pair is computed once per goal, after which a full
+// evaluation is 8 lookups and a move changes h by exactly one lookup pair,
+// since only one tile moves.
+//
+// Linear conflict adds 2 moves to Manhattan for each tile that must leave its
+// goal row (or column) to let another tile in that line pass it. The extra
+// cost of every possible line is precomputed per goal; a move changes only
+// the two lines the moving tile leaves and enters.
+//
+// Walking distance (Takahashi) counts, for each row, how many tiles belong
+// in each goal row, and finds by BFS the fewest vertical moves that sort
+// those counts; columns are done the same way. Both tables are built once per
+// goal and a move steps one of the two table indices through a transition
+// table. The indices travel with the state as a 32-bit heuristic key.
+//
+// Heuristic bundles all of these behind one interface selected by name.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "packed_state.h"
+
+using namespace std;
+
+class TileDistanceTable
+{
+public:
+	TileDistanceTable();
+	void buildManhattan(PackedState goal);				//Cost = rows + columns between a tile and its goal position
+	void buildMisplaced(PackedState goal);				//Cost = 1 if a tile is not at its goal position
+	int evaluate(PackedState state);					//Sum of the cost of every tile (the blank is free)
+	int getMoveDelta(PackedState parent, PackedState child);	//Change in h from parent to child (one move apart)
+	int getCost(int tile, int position);
+
+protected:
+	unsigned char m_nCost[9][9];	// [tile][position]. Row 0 (the blank) stays 0
+};
+
+class LinearConflictTable
+{
+public:
+	void build(PackedState goal);						//Builds the Manhattan table and the conflict cost of every line
+	int evaluate(PackedState state);					//Manhattan distance plus every line's conflict cost
+	int getMoveDelta(PackedState parent, PackedState child);	//Change in h from parent to child (one move apart)
+
+protected:
+	int getRowKey(PackedState state, int row);			//Base 9 key of the tiles in a row, or column
+	int getColKey(PackedState state, int col);
+
+	TileDistanceTable m_Manhattan;
+	unsigned char m_nRowConflict[3][729];	// [row][key] extra moves for tiles in their goal row
+	unsigned char m_nColConflict[3][729];	// [col][key] extra moves for tiles in their goal column
+};
+
+class WalkingDistanceTable
+{
+public:
+	void build(int goalBlankLine);						//BFS over count tables for a goal with the blank in the given row (or column)
+	int getIndex(int counts[3][3]);						//Table index for counts[line][goal line], -1 if invalid
+	int getDistance(int index);
+	int getNext(int index, int fromLine, int goalLine);	//Index after a tile with goalLine moves from fromLine into the blank's line
+
+protected:
+	uint32_t getCode(int counts[3][3]);					//2 bits per count, 18 bits in all
+
+	map<uint32_t, int> m_mIndices;		// Code of each reachable count table -> index
+	vector<unsigned char> m_vDistance;	// [index] moves needed to sort the counts
+	vector<uint32_t> m_vCodes;			// [index] code of the count table
+	vector<int> m_vNext;				// [index * 9 + fromLine * 3 + goalLine] -> index, -1 if illegal
+};
+
+enum HeuristicType
+{
+	H_MISPLACED,
+	H_MANHATTAN,
+	H_LINEAR_CONFLICT,
+	H_WALKING_DISTANCE,
+	H_PATTERN_DB		// Additive pattern databases, NxN engines only (see pattern_db.h)
+};
+
+bool getHeuristicType(string name, HeuristicType &type); //Accepts TOOP, Manhattan, Linear Conflict or Walking Distance
+
+class Heuristic
+{
+public:
+	Heuristic();
+	void build(PackedState goal, HeuristicType type);	//Builds the tables type needs for goal
+	HeuristicType getType();
+	PackedState getGoal();
+	int evaluate(PackedState state, uint32_t &nKey);	//Full evaluation. nKey receives the state's heuristic key
+	int getChildValue(PackedState parent, int h, uint32_t &nKey, PackedState child);	//Incremental evaluation. nKey goes from parent's to child's
+
+protected:
+	HeuristicType m_Type;
+	PackedState m_Goal;
+	int m_nGoalRow[9];					// Goal row and column of each tile, for walking distance
+	int m_nGoalCol[9];
+	TileDistanceTable m_TileTable;
+	LinearConflictTable m_LinearConflict;
+	WalkingDistanceTable m_VerticalWD;	// Counts per row, goal blank row
+	WalkingDistanceTable m_HorizontalWD;	// Counts per column, goal blank column
+};
+
+//Constructor. Every cost is 0 until a build function is called.
+TileDistanceTable::TileDistanceTable()
+{
+	for (int t = 0; t < 9; t++)
+		for (int p = 0; p < 9; p++)
+			m_nCost[t][p] = 0;
+}
+
+void TileDistanceTable::buildManhattan(PackedState goal)
+{
+	for (int g = 0; g < 9; g++)
+	{
+		int nTile = getPackedTile(goal, g);
+		for (int p = 0; p < 9; p++)
+			m_nCost[nTile][p] = (nTile == 0) ? 0 : (unsigned char)(abs(p / 3 - g / 3) + abs(p % 3 - g % 3));
+	}
+}
+
+void TileDistanceTable::buildMisplaced(PackedState goal)
+{
+	for (int g = 0; g < 9; g++)
+	{
+		int nTile = getPackedTile(goal, g);
+		for (int p = 0; p < 9; p++)
+			m_nCost[nTile][p] = (nTile != 0 && p != g) ? 1 : 0;
+	}
+}
+
+int TileDistanceTable::evaluate(PackedState state)
+{
+	int h = 0;
+	for (int p = 0; p < 9; p++)
+		h += m_nCost[getPackedTile(state, p)][p];
+	return h;
+}
+
+//The tile that moved sat where the child's blank is and now sits where the parent's blank was
+int TileDistanceTable::getMoveDelta(PackedState parent, PackedState child)
+{
+	int nTile = getPackedTile(parent, child.m_nBlank);
+	return m_nCost[nTile][parent.m_nBlank] - m_nCost[nTile][child.m_nBlank];
+}
+
+int TileDistanceTable::getCost(int tile, int position)
+{
+	return m_nCost[tile][position];
+}
+
+//Builds the Manhattan table, then the conflict cost of every possible row and column.
+//For a line, tiles whose goal is in that line must keep their goal order; every tile
+//that has to step out of the line to allow it costs 2 extra moves. The fewest tiles to
+//remove is the line's tile count minus its longest run that is in goal order.
+void LinearConflictTable::build(PackedState goal)
+{
+	m_Manhattan.buildManhattan(goal);
+
+	int nGoalPos[9];
+	for (int p = 0; p < 9; p++)
+		nGoalPos[getPackedTile(goal, p)] = p;
+
+	for (int nLine = 0; nLine < 3; nLine++)
+	{
+		for (int nKey = 0; nKey < 729; nKey++)
+		{
+			int nTiles[3] = { nKey / 81, (nKey / 9) % 9, nKey % 9 };
+			int nRowOrder[3]; //goal column of each tile that belongs in this row, else -1
+			int nColOrder[3]; //goal row of each tile that belongs in this column, else -1
+			for (int i = 0; i < 3; i++)
+			{
+				int nGoal = nGoalPos[nTiles[i]];
+				bool bTile = nTiles[i] != 0;
+				nRowOrder[i] = (bTile && nGoal / 3 == nLine) ? nGoal % 3 : -1;
+				nColOrder[i] = (bTile && nGoal % 3 == nLine) ? nGoal / 3 : -1;
+			}
+
+			//Try every subset of the 3 cells and keep the largest one that is in goal order
+			int nRowBest = 0, nColBest = 0, nRowCount = 0, nColCount = 0;
+			for (int i = 0; i < 3; i++)
+			{
+				nRowCount += nRowOrder[i] >= 0;
+				nColCount += nColOrder[i] >= 0;
+			}
+			for (int nMask = 1; nMask < 8; nMask++)
+			{
+				int nRowLast = -1, nColLast = -1, nSize = 0;
+				bool bRowOk = true, bColOk = true;
+				for (int i = 0; i < 3; i++)
+				{
+					if (!(nMask & (1 << i)))
+						continue;
+					nSize++;
+					bRowOk = bRowOk && nRowOrder[i] > nRowLast;
+					bColOk = bColOk && nColOrder[i] > nColLast;
+					nRowLast = nRowOrder[i];
+					nColLast = nColOrder[i];
+				}
+				if (bRowOk && nSize > nRowBest)
+					nRowBest = nSize;
+				if (bColOk && nSize > nColBest)
+					nColBest = nSize;
+			}
+			m_nRowConflict[nLine][nKey] = (unsigned char)(2 * (nRowCount - nRowBest));
+			m_nColConflict[nLine][nKey] = (unsigned char)(2 * (nColCount - nColBest));
+		}
+	}
+}
+
+int LinearConflictTable::evaluate(PackedState state)
+{
+	int h = m_Manhattan.evaluate(state);
+	for (int nLine = 0; nLine < 3; nLine++)
+		h += m_nRowConflict[nLine][getRowKey(state, nLine)] + m_nColConflict[nLine][getColKey(state, nLine)];
+	return h;
+}
+
+//A horizontal move keeps the tile order of its row and changes two columns.
+//A vertical move keeps the tile order of its column and changes two rows.
+int LinearConflictTable::getMoveDelta(PackedState parent, PackedState child)
+{
+	int nDelta = m_Manhattan.getMoveDelta(parent, child);
+	int nRowA = parent.m_nBlank / 3, nRowB = child.m_nBlank / 3;
+	if (nRowA == nRowB)
+	{
+		int nColA = parent.m_nBlank % 3, nColB = child.m_nBlank % 3;
+		nDelta += m_nColConflict[nColA][getColKey(child, nColA)] - m_nColConflict[nColA][getColKey(parent, nColA)];
+		nDelta += m_nColConflict[nColB][getColKey(child, nColB)] - m_nColConflict[nColB][getColKey(parent, nColB)];
+	}
+	else
+	{
+		nDelta += m_nRowConflict[nRowA][getRowKey(child, nRowA)] - m_nRowConflict[nRowA][getRowKey(parent, nRowA)];
+		nDelta += m_nRowConflict[nRowB][getRowKey(child, nRowB)] - m_nRowConflict[nRowB][getRowKey(parent, nRowB)];
+	}
+	return nDelta;
+}
+
+int LinearConflictTable::getRowKey(PackedState state, int row)
+{
+	return getPackedTile(state, row * 3) * 81 + getPackedTile(state, row * 3 + 1) * 9 + getPackedTile(state, row * 3 + 2);
+}
+
+int LinearConflictTable::getColKey(PackedState state, int col)
+{
+	return getPackedTile(state, col) * 81 + getPackedTile(state, col + 3) * 9 + getPackedTile(state, col + 6);
+}
+
+//Breadth first search from the goal's count table. counts[line][g] is the number of
+//tiles in that line whose goal is line g; the line holding the blank has 2 tiles.
+//Each step moves one tile from a line next to the blank's line into it.
+void WalkingDistanceTable::build(int goalBlankLine)
+{
+	m_mIndices.clear();
+	m_vDistance.clear();
+	m_vCodes.clear();
+
+	int nCounts[3][3] = { { 0 } };
+	for (int nLine = 0; nLine < 3; nLine++)
+		nCounts[nLine][nLine] = (nLine == goalBlankLine) ? 2 : 3;
+	m_mIndices[getCode(nCounts)] = 0;
+	m_vCodes.push_back(getCode(nCounts));
+	m_vDistance.push_back(0);
+
+	//m_vCodes doubles as the BFS queue
+	for (unsigned int nIndex = 0; nIndex < m_vCodes.size(); nIndex++)
+	{
+		int nBlankLine = 0;
+		for (int nLine = 0; nLine < 3; nLine++)
+		{
+			int nSum = 0;
+			for (int g = 0; g < 3; g++)
+			{
+				nCounts[nLine][g] = (m_vCodes[nIndex] >> (2 * (nLine * 3 + g))) & 3;
+				nSum += nCounts[nLine][g];
+			}
+			if (nSum == 2)
+				nBlankLine = nLine;
+		}
+
+		for (int nFrom = nBlankLine - 1; nFrom <= nBlankLine + 1; nFrom += 2)
+		{
+			if (nFrom < 0 || nFrom > 2)
+				continue;
+			for (int g = 0; g < 3; g++)
+			{
+				if (nCounts[nFrom][g] == 0)
+					continue;
+				nCounts[nFrom][g]--;
+				nCounts[nBlankLine][g]++;
+				uint32_t nCode = getCode(nCounts);
+				if (m_mIndices.find(nCode) == m_mIndices.end())
+				{
+					m_mIndices[nCode] = (int)m_vCodes.size();
+					m_vCodes.push_back(nCode);
+					m_vDistance.push_back(m_vDistance[nIndex] + 1);
+				}
+				nCounts[nFrom][g]++;
+				nCounts[nBlankLine][g]--;
+			}
+		}
+	}
+
+	//Transition table, so a move updates the index without rebuilding the counts
+	m_vNext.assign(m_vCodes.size() * 9, -1);
+	for (unsigned int nIndex = 0; nIndex < m_vCodes.size(); nIndex++)
+	{
+		int nBlankLine = 0;
+		for (int nLine = 0; nLine < 3; nLine++)
+		{
+			int nSum = 0;
+			for (int g = 0; g < 3; g++)
+			{
+				nCounts[nLine][g] = (m_vCodes[nIndex] >> (2 * (nLine * 3 + g))) & 3;
+				nSum += nCounts[nLine][g];
+			}
+			if (nSum == 2)
+				nBlankLine = nLine;
+		}
+		for (int nFrom = 0; nFrom < 3; nFrom++)
+		{
+			if (nFrom != nBlankLine - 1 && nFrom != nBlankLine + 1)
+				continue;
+			for (int g = 0; g < 3; g++)
+			{
+				if (nCounts[nFrom][g] == 0)
+					continue;
+				nCounts[nFrom][g]--;
+				nCounts[nBlankLine][g]++;
+				m_vNext[nIndex * 9 + nFrom * 3 + g] = m_mIndices[getCode(nCounts)];
+				nCounts[nFrom][g]++;
+				nCounts[nBlankLine][g]--;
+			}
+		}
+	}
+}
+
+int WalkingDistanceTable::getIndex(int counts[3][3])
+{
+	map<uint32_t, int>::iterator it = m_mIndices.find(getCode(counts));
+	return (it == m_mIndices.end()) ? -1 : it->second;
+}
+
+int WalkingDistanceTable::getDistance(int index)
+{
+	return m_vDistance[index];
+}
+
+int WalkingDistanceTable::getNext(int index, int fromLine, int goalLine)
+{
+	return m_vNext[index * 9 + fromLine * 3 + goalLine];
+}
+
+uint32_t WalkingDistanceTable::getCode(int counts[3][3])
+{
+	uint32_t nCode = 0;
+	for (int nLine = 0; nLine < 3; nLine++)
+		for (int g = 0; g < 3; g++)
+			nCode |= (uint32_t)counts[nLine][g] << (2 * (nLine * 3 + g));
+	return nCode;
+}
+
+//Maps a heuristic name to its type. Returns false if the name is unknown
+bool getHeuristicType(string name, HeuristicType &type)
+{
+	if (name == "TOOP")
+		type = H_MISPLACED;
+	else if (name == "Manhattan")
+		type = H_MANHATTAN;
+	else if (name == "Linear Conflict")
+		type = H_LINEAR_CONFLICT;
+	else if (name == "Walking Distance")
+		type = H_WALKING_DISTANCE;
+	else
+		return false;
+	return true;
+}
+
+//Constructor. Defaults to Manhattan distance, though no tables exist until build is called
+Heuristic::Heuristic() : m_Type(H_MANHATTAN)
+{
+	m_Goal.m_nTiles = 0;
+	m_Goal.m_nBlank = 0;
+}
+
+//Builds only the tables type needs for goal
+void Heuristic::build(PackedState goal, HeuristicType type)
+{
+	m_Type = type;
+	m_Goal = goal;
+	for (int p = 0; p < 9; p++)
+	{
+		m_nGoalRow[getPackedTile(goal, p)] = p / 3;
+		m_nGoalCol[getPackedTile(goal, p)] = p % 3;
+	}
+
+	switch (type)
+	{
+	case H_MISPLACED:
+		m_TileTable.buildMisplaced(goal);
+		break;
+	case H_MANHATTAN:
+	case H_PATTERN_DB: //built by the NxN engines only; 3x3 falls back to Manhattan
+		m_TileTable.buildManhattan(goal);
+		break;
+	case H_LINEAR_CONFLICT:
+		m_LinearConflict.build(goal);
+		break;
+	case H_WALKING_DISTANCE:
+		m_VerticalWD.build(goal.m_nBlank / 3);
+		m_HorizontalWD.build(goal.m_nBlank % 3);
+		break;
+	}
+}
+
+HeuristicType Heuristic::getType()
+{
+	return m_Type;
+}
+
+//Goal the tables were built for. Before build no state matches it
+PackedState Heuristic::getGoal()
+{
+	return m_Goal;
+}
+
+//Full evaluation of state. For walking distance nKey receives the vertical table index
+//in its low 16 bits and the horizontal in its high 16 bits, else it is 0.
+int Heuristic::evaluate(PackedState state, uint32_t &nKey)
+{
+	nKey = 0;
+	switch (m_Type)
+	{
+	case H_LINEAR_CONFLICT:
+		return m_LinearConflict.evaluate(state);
+	case H_WALKING_DISTANCE:
+	{
+		int nRows[3][3] = { { 0 } };
+		int nCols[3][3] = { { 0 } };
+		for (int p = 0; p < 9; p++)
+		{
+			int nTile = getPackedTile(state, p);
+			if (nTile == 0)
+				continue;
+			nRows[p / 3][m_nGoalRow[nTile]]++;
+			nCols[p % 3][m_nGoalCol[nTile]]++;
+		}
+		int nVertical = m_VerticalWD.getIndex(nRows);
+		int nHorizontal = m_HorizontalWD.getIndex(nCols);
+		nKey = (uint32_t)nVertical | ((uint32_t)nHorizontal << 16);
+		return m_VerticalWD.getDistance(nVertical) + m_HorizontalWD.getDistance(nHorizontal);
+	}
+	default:
+		return m_TileTable.evaluate(state);
+	}
+}
+
+//Value for child given parent's value h. nKey holds parent's key on entry and child's on return.
+int Heuristic::getChildValue(PackedState parent, int h, uint32_t &nKey, PackedState child)
+{
+	switch (m_Type)
+	{
+	case H_LINEAR_CONFLICT:
+		return h + m_LinearConflict.getMoveDelta(parent, child);
+	case H_WALKING_DISTANCE:
+	{
+		//The tile moves from the child's blank position into the parent's blank position
+		int nTile = getPackedTile(parent, child.m_nBlank);
+		int nVertical = nKey & 0xFFFF;
+		int nHorizontal = nKey >> 16;
+		if (parent.m_nBlank / 3 != child.m_nBlank / 3)
+			nVertical = m_VerticalWD.getNext(nVertical, child.m_nBlank / 3, m_nGoalRow[nTile]);
+		else
+			nHorizontal = m_HorizontalWD.getNext(nHorizontal, child.m_nBlank % 3, m_nGoalCol[nTile]);
+		nKey = (uint32_t)nVertical | ((uint32_t)nHorizontal << 16);
+		return m_VerticalWD.getDistance(nVertical) + m_HorizontalWD.getDistance(nHorizontal);
+	}
+	default:
+		return h + m_TileTable.getMoveDelta(parent, child);
+	}
+}
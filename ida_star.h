@@ -0,0 +1,138 @@
+/////////////////////////////////////////////////////////////
+// Iterative-deepening A* for eight_tile_solver.
+//
+// Depth-first searches bounded by f = g + h, raising the bound to the smallest
+// f that exceeded it until the goal is reached. Only one board exists: moves
+// are made and unmade on it in place, the move that would undo the previous
+// one is never tried, and the heuristic is updated from the single tile that
+// slides. Memory use is O(solution depth), with no open list.
+// Does no console output, so it may be called from any non-interactive code.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <vector>
+#include <limits.h>
+#include "packed_state.h"
+#include "state_rank.h"
+#include "heuristics.h"
+#include "search_stats.h"
+#include "move_string.h"
+
+using namespace std;
+
+#define IDA_FOUND -1
+
+struct IDAStarContext
+{
+	PackedState m_State;	// The single mutable board
+	PackedState m_Goal;
+	Heuristic *m_pHeuristic;	// Heuristic tables for m_Goal
+	MoveString m_Path;	// Moves made from the start to reach m_State
+	SearchStats *m_pStats;	// Filled over all iterations
+};
+
+bool solveIDAStar(PackedState start, PackedState goal, MoveString &path, SearchStats &stats, HeuristicType heuristic = H_MANHATTAN); //Fills path with an optimal solution. Returns false if unsolvable
+bool solveIDAStar(PackedState start, Heuristic &heuristic, MoveString &path, SearchStats &stats); //As above, with tables already built for the goal
+int searchIDAStarBound(IDAStarContext &ctx, int g, int h, uint32_t nKey, int nBound, int nLastMove); //One bounded DFS. Returns IDA_FOUND or the smallest f over the bound
+
+//Fills path with an optimal solution from start to goal.
+//stats receives the counts over every iteration; nodes re-generated by a later
+//iteration are counted again.
+bool solveIDAStar(PackedState start, PackedState goal, MoveString &path, SearchStats &stats, HeuristicType heuristic)
+{
+	Heuristic tables;
+	tables.build(goal, heuristic);
+	return solveIDAStar(start, tables, path, stats);
+}
+
+//Solves toward the goal heuristic was built for. Lets callers solving many puzzles
+//for one goal build the tables once.
+bool solveIDAStar(PackedState start, Heuristic &heuristic, MoveString &path, SearchStats &stats)
+{
+	path.clear();
+	clearSearchStats(stats);
+	PackedState goal = heuristic.getGoal();
+	if (getStateParity(start) != getStateParity(goal))
+		return false; //unreachable, every iteration would fail
+
+	IDAStarContext ctx;
+	ctx.m_State = start;
+	ctx.m_Goal = goal;
+	ctx.m_pStats = &stats;
+	ctx.m_Path.reserve(64); //no 8-puzzle solution is longer than 31 moves
+	ctx.m_pHeuristic = &heuristic;
+
+	uint32_t nKey;
+	int h = ctx.m_pHeuristic->evaluate(start, nKey);
+	stats.m_nHeuristicEvaluations++;
+
+	int nBound = h;
+	while (true)
+	{
+		int nResult = searchIDAStarBound(ctx, 0, h, nKey, nBound, -1);
+		if (nResult == IDA_FOUND)
+			break;
+		nBound = nResult;
+	}
+
+	path = ctx.m_Path;
+	return true;
+}
+
+//Depth first search from ctx.m_State, cutting off any node with g + h > nBound.
+//Returns IDA_FOUND with the solution in ctx.m_Path, or else the smallest f that
+//exceeded the bound (the next iteration's bound). ctx.m_State is restored on return.
+int searchIDAStarBound(IDAStarContext &ctx, int g, int h, uint32_t nKey, int nBound, int nLastMove)
+{
+	int f = g + h;
+	if (f > nBound)
+	{
+		ctx.m_pStats->m_nPruned++;
+		return f;
+	}
+	if (ctx.m_State == ctx.m_Goal)
+		return IDA_FOUND;
+
+	SearchStats &stats = *ctx.m_pStats;
+	stats.m_nExpanded++;
+	int nMin = INT_MAX;
+	const PackedMoves &moves = getPackedMoves(ctx.m_State); //legal moves from this blank position
+	for (int i = 0; i < moves.m_nCount; i++)
+	{
+		//Skip the move that undoes the last one ([0]<->[1], [2]<->[3])
+		int move = moves.m_nMoves[i];
+		if (move == (nLastMove ^ 1))
+			continue;
+
+		//Make the move, updating h from the one tile that slides into the blank
+		PackedState parent = ctx.m_State;
+		{
+			PhaseTimer timer(stats, PHASE_EXPAND);
+			ctx.m_State = slidePackedTile(parent, move);
+			ctx.m_Path.push_back(move);
+		}
+		uint32_t nChildKey = nKey;
+		int nChildH;
+		{
+			PhaseTimer timer(stats, PHASE_HEURISTIC);
+			nChildH = ctx.m_pHeuristic->getChildValue(parent, h, nChildKey, ctx.m_State);
+		}
+		stats.m_nGenerated++;
+		stats.m_nHeuristicEvaluations++;
+		updateSearchPeak(stats.m_nPeakOpen, ctx.m_Path.size());
+
+		int nResult = searchIDAStarBound(ctx, g + 1, nChildH, nChildKey, nBound, move);
+		if (nResult == IDA_FOUND)
+			return IDA_FOUND;
+		if (nResult < nMin)
+			nMin = nResult;
+
+		//Unmake the move by sliding the tile back
+		ctx.m_Path.pop_back();
+		ctx.m_State = slidePackedTile(ctx.m_State, move ^ 1);
+	}
+	return nMin;
+}
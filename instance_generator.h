@@ -0,0 +1,115 @@
+/////////////////////////////////////////////////////////////
+// Random instance generator for eight_tile_solver.
+//
+// Draws puzzles from a seeded mt19937_64, so a seed gives the same puzzles on
+// every run and platform. A 3x3 puzzle is a rank drawn uniformly from the
+// goal's parity class and unranked (see state_rank.h), so every solvable start
+// is equally likely and one costs a draw and an unrank, not a random walk.
+// Draws are made by rejection from the raw 64-bit output rather than with
+// uniform_int_distribution, whose results differ between standard libraries.
+// For puzzles of an exact optimal depth, the generator is handed the goal's
+// ranks grouped by depth once (see DistanceDatabase::getRanksByDepth), after
+// which a draw picks uniformly among the states of that depth. Taking the
+// ranks rather than the database keeps this header free of the database and
+// its file and thread code, so the console board code can include it. NxN
+// boards are shuffled with Fisher-Yates and, if the parity is wrong, two
+// tiles are swapped, which is also uniform over the solvable boards.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <random>
+#include <vector>
+#include "packed_state.h"
+#include "state_rank.h"
+#include "nxn_board.h"
+
+using namespace std;
+
+class InstanceGenerator
+{
+public:
+	InstanceGenerator(uint64_t nSeed = 2016);
+	void seed(uint64_t nSeed);
+	uint64_t getUniform(uint64_t nCount);					//Uniform in [0, nCount)
+	PackedState next(PackedState goal);						//Uniform among the starts that can reach goal, goal included
+	void setDepthIndex(PackedState goal, const vector< vector<int> > &vRanksByDepth);	//[depth] = ranks of goal's parity class that far from goal, for nextAtDepth
+	int getMaxDepth();										//Deepest depth indexed, -1 before setDepthIndex
+	bool nextAtDepth(int nDepth, PackedState &state);		//Uniform among the states nDepth moves from the indexed goal. False if there are none
+	template<int N> BoardState<N> nextBoard(const BoardState<N> &goal); //Uniform among the boards that can reach goal
+
+protected:
+	mt19937_64 m_Rng;
+	int m_nParity;								// Parity class the depth index was built for
+	vector< vector<int> > m_vRanksByDepth;		// [depth] = ranks of the states that far from the goal
+};
+
+InstanceGenerator::InstanceGenerator(uint64_t nSeed) : m_Rng(nSeed), m_nParity(0)
+{
+}
+
+void InstanceGenerator::seed(uint64_t nSeed)
+{
+	m_Rng.seed(nSeed);
+}
+
+//Draws again whenever the value falls in the short last block of 2^64 mod nCount values
+uint64_t InstanceGenerator::getUniform(uint64_t nCount)
+{
+	uint64_t nLimit = UINT64_MAX - UINT64_MAX % nCount;
+	uint64_t nValue;
+	do
+		nValue = m_Rng();
+	while (nValue >= nLimit);
+	return nValue % nCount;
+}
+
+PackedState InstanceGenerator::next(PackedState goal)
+{
+	return unrankState((int)getUniform(NUM_STATE_RANKS), getStateParity(goal));
+}
+
+void InstanceGenerator::setDepthIndex(PackedState goal, const vector< vector<int> > &vRanksByDepth)
+{
+	m_nParity = getStateParity(goal);
+	m_vRanksByDepth = vRanksByDepth;
+}
+
+int InstanceGenerator::getMaxDepth()
+{
+	return (int)m_vRanksByDepth.size() - 1;
+}
+
+bool InstanceGenerator::nextAtDepth(int nDepth, PackedState &state)
+{
+	if (nDepth < 0 || nDepth > getMaxDepth() || m_vRanksByDepth[nDepth].empty())
+		return false;
+	vector<int> &vRanks = m_vRanksByDepth[nDepth];
+	state = unrankState(vRanks[getUniform(vRanks.size())], m_nParity);
+	return true;
+}
+
+//Swapping two tiles flips the parity and keeps the blank where it is, so it pairs
+//each board of the wrong parity with exactly one of the right parity
+template<int N>
+BoardState<N> InstanceGenerator::nextBoard(const BoardState<N> &goal)
+{
+	int nTiles[N * N];
+	for (int p = 0; p < N * N; p++)
+		nTiles[p] = p;
+	for (int p = N * N - 1; p > 0; p--)
+		swap(nTiles[p], nTiles[getUniform(p + 1)]);
+
+	BoardState<N> board = packBoard<N>(nTiles);
+	if (getBoardParity<N>(board) != getBoardParity<N>(goal))
+	{
+		int nFirst = (nTiles[0] == 0) ? 1 : 0;	//the first two tiles that aren't the blank
+		int nSecond = (nTiles[nFirst + 1] == 0) ? nFirst + 2 : nFirst + 1;
+		swap(nTiles[nFirst], nTiles[nSecond]);
+		board = packBoard<N>(nTiles);
+	}
+	return board;
+}
@@ -0,0 +1,132 @@
+/////////////////////////////////////////////////////////////
+// Read-only memory mapped file for eight_tile_solver.
+//
+// Used for precomputed tables so they are paged in by the OS on demand and
+// shared between processes, rather than read into the heap at startup.
+// A table is written to a temp file and moved into place once complete, so
+// an interrupted build never leaves a truncated file under the real name.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <string>
+#include <Windows.h>
+
+using namespace std;
+
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+	bool open(string path);						//Maps the whole file read-only. Returns false on failure
+	void close();								//Unmaps the file, if one is mapped
+	bool isOpen();								//Accessors..
+	const unsigned char* getData();
+	size_t getSize();
+
+protected:
+	HANDLE m_hFile;
+	HANDLE m_hMapping;
+	const unsigned char* m_pData;
+	size_t m_nSize;
+
+private:
+	MappedFile(const MappedFile &);				//Not copyable, the object owns the mapping
+	MappedFile &operator =(const MappedFile &);
+};
+
+string getTempFilePath(string path);				//Unique per process name next to path, for writing it
+bool replaceFile(string tempPath, string path);		//Moves a finished temp file to path, replacing any file there
+bool deleteFile(string path);
+
+//Constructor
+MappedFile::MappedFile() : m_hFile(INVALID_HANDLE_VALUE), m_hMapping(NULL), m_pData(nullptr), m_nSize(0)
+{
+}
+
+//Destructor
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+//Maps the whole file read-only. Returns false if it does not exist or can't be mapped
+bool MappedFile::open(string path)
+{
+	close();
+	m_hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (m_hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER nFileSize;
+	if (!GetFileSizeEx(m_hFile, &nFileSize) || nFileSize.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+
+	m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_hMapping == NULL)
+	{
+		close();
+		return false;
+	}
+
+	m_pData = static_cast<const unsigned char*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_pData == nullptr)
+	{
+		close();
+		return false;
+	}
+	m_nSize = (size_t)nFileSize.QuadPart;
+	return true;
+}
+
+//Unmaps the file, if one is mapped
+void MappedFile::close()
+{
+	if (m_pData != nullptr)
+		UnmapViewOfFile(m_pData);
+	if (m_hMapping != NULL)
+		CloseHandle(m_hMapping);
+	if (m_hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(m_hFile);
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = NULL;
+	m_pData = nullptr;
+	m_nSize = 0;
+}
+
+//Accessors
+bool MappedFile::isOpen()
+{
+	return m_pData != nullptr;
+}
+const unsigned char* MappedFile::getData()
+{
+	return m_pData;
+}
+size_t MappedFile::getSize()
+{
+	return m_nSize;
+}
+
+//Returns path with the process id appended, so two processes building the same table don't share a temp file
+string getTempFilePath(string path)
+{
+	return path + "." + to_string(GetCurrentProcessId()) + ".tmp";
+}
+
+//Replaces in one step, so readers see either the old file or the complete new one
+bool replaceFile(string tempPath, string path)
+{
+	return MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+bool deleteFile(string path)
+{
+	return DeleteFileA(path.c_str()) != 0;
+}
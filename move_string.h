@@ -0,0 +1,147 @@
+/////////////////////////////////////////////////////////////
+// Packed move strings for eight_tile_solver.
+//
+// A solution is a sequence of moves, each one of [0] = left, [1] = right,
+// [2] = up, [3] = down, so a move fits in 2 bits. MoveString keeps 32 moves
+// per 64-bit word (every 8-puzzle solution fits in one), with the operations
+// the engines need to build a path: push_back/pop_back at the end for depth
+// first searches, and resize/set for filling a path backward from parent
+// links. A MoveString holds no search state, so a result can be kept or
+// shipped after the search tree is released and replayed from its start.
+// Words are kept across clear() so a reused string stops allocating.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "packed_state.h"
+#include "nxn_board.h"
+
+using namespace std;
+
+#define MOVE_BITS 2						// Bits per packed move
+#define MOVES_PER_WORD (64 / MOVE_BITS)
+
+class MoveString
+{
+public:
+	MoveString();
+	void push_back(int move);
+	void pop_back();
+	int operator [](size_t i) const;	//Move i, 0 being the first from the start
+	void set(size_t i, int move);
+	size_t size() const;
+	bool empty() const;
+	void resize(size_t nSize);			//New moves are [0] = left until set
+	void reserve(size_t nSize);
+	void clear();						//Removes every move, keeping the words
+	void reverse();
+
+protected:
+	vector<uint64_t> m_vWords;
+	size_t m_nSize;
+};
+
+PackedState replayMoves(PackedState start, const MoveString &moves); //Returns the state reached by making moves from start. Moves must be legal
+template<int N> BoardState<N> replayBoardMoves(const BoardState<N> &start, const MoveString &moves); //As above, for NxN boards
+template<class T> void getPathMoves(T *node, MoveString &path); //Fills path with the actions from the root to node, for Node or BoardNode<N>
+
+MoveString::MoveString() : m_nSize(0)
+{
+}
+
+void MoveString::push_back(int move)
+{
+	if (m_nSize == m_vWords.size() * MOVES_PER_WORD)
+		m_vWords.push_back(0);
+	set(m_nSize++, move);
+}
+
+void MoveString::pop_back()
+{
+	m_nSize--;
+}
+
+int MoveString::operator [](size_t i) const
+{
+	return (int)(m_vWords[i / MOVES_PER_WORD] >> ((i % MOVES_PER_WORD) * MOVE_BITS)) & 3;
+}
+
+//Clears the move's bits first, since words are reused after pop_back and clear
+void MoveString::set(size_t i, int move)
+{
+	int nShift = (int)(i % MOVES_PER_WORD) * MOVE_BITS;
+	uint64_t &nWord = m_vWords[i / MOVES_PER_WORD];
+	nWord = (nWord & ~(3ULL << nShift)) | ((uint64_t)move << nShift);
+}
+
+size_t MoveString::size() const
+{
+	return m_nSize;
+}
+
+bool MoveString::empty() const
+{
+	return m_nSize == 0;
+}
+
+void MoveString::resize(size_t nSize)
+{
+	size_t nWords = (nSize + MOVES_PER_WORD - 1) / MOVES_PER_WORD;
+	if (nWords > m_vWords.size())
+		m_vWords.resize(nWords);
+	for (size_t i = m_nSize; i < nSize; i++)
+		set(i, 0);
+	m_nSize = nSize;
+}
+
+void MoveString::reserve(size_t nSize)
+{
+	m_vWords.reserve((nSize + MOVES_PER_WORD - 1) / MOVES_PER_WORD);
+}
+
+void MoveString::clear()
+{
+	m_nSize = 0;
+}
+
+void MoveString::reverse()
+{
+	for (size_t i = 0, j = m_nSize; i + 1 < j; i++, j--)
+	{
+		int nTemp = (*this)[i];
+		set(i, (*this)[j - 1]);
+		set(j - 1, nTemp);
+	}
+}
+
+PackedState replayMoves(PackedState start, const MoveString &moves)
+{
+	PackedState state = start;
+	for (size_t i = 0; i < moves.size(); i++)
+		state = slidePackedTile(state, moves[i]);
+	return state;
+}
+
+template<int N>
+BoardState<N> replayBoardMoves(const BoardState<N> &start, const MoveString &moves)
+{
+	BoardState<N> state = start;
+	for (size_t i = 0; i < moves.size(); i++)
+		state = slideBoardTile<N>(state, moves[i]);
+	return state;
+}
+
+//Follows parent pointers from node to the root. The node's depth gives the length,
+//so the moves are written back to front in place.
+template<class T>
+void getPathMoves(T *node, MoveString &path)
+{
+	path.clear();
+	path.resize(node->getDepth() - 1);
+	for (size_t i = path.size(); i > 0; node = node->getParent())
+		path.set(--i, node->getAction());
+}
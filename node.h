@@ -2,8 +2,9 @@
 // Node object for eight_tile_solver.
 //
 // Node has State, Action, Parent, and Path Cost properites and ptr to Parent
-// In this implementation, state is an int* of size 9. This may be adjusted for
-// larger puzzles.
+// The depth (g + 1) is stored when the node is made, so reading it is O(1).
+// In this implementation, state is a PackedState (4 bits per tile in one 64-bit
+// word, see packed_state.h). This may be adjusted for larger puzzles.
 // Includes interface and implementation.
 //
 /// Dustin Fast (dustin.fast@outlook.com), 2016
@@ -12,99 +13,80 @@
 
 #include <string>
 #include <iostream>
-#include "board.h"
+#include <stdint.h>
+#include "packed_state.h"
 
 using namespace std;
 
 class Node
 {
 public:
-	Node(int state[9]);								//root node constructor
-	Node(int state[9], int action, Node* parent);   //Child node constructor. Does action to state in constructor
-	int* getLinearState();							//Accessors..
+	Node(PackedState state);						//root node constructor
+	Node(PackedState state, int action, Node* parent);  //Child node constructor. Does action to state in constructor
+	PackedState getState();							//Accessors..
 	void getLinearState(int container[9]);
 	void getMatrixState(int container[3][3]);
 	int getAction();
-	int getDepth();									//Return the depth of the node by following the parent pointer up to the root
+	int getDepth();									//Returns the depth of the node, 1 at the root. Path cost g is getDepth() - 1
 	int getTotalCost();								//Returns m_nTotalCost, which must be set independently by cvalling setTotalCost, else it is 0
+	int getHeuristic();								//Returns m_nHeuristic, which must be set by calling setHeuristic, else it is 0
+	uint32_t getHeuristicKey();
 	Node* getParent();
-	Node* getSelf();
 	void setTotalCost(int cost);
-	friend bool operator <(const Node &A, const Node &B);
+	void setHeuristic(int h, uint32_t key = 0);
 
 
 protected:
-	int m_nState[9];		// Representation of a 3x3 matrix state in linear form (ex: 1,2,3,4,5,6,7,8,0)
+	PackedState m_State;	// Packed representation of a 3x3 matrix state (ex: 1,2,3,4,5,6,7,8,0)
 	int m_nTotalCost;
+	int m_nHeuristic;		// h of this state, kept so a child's h can be updated from it incrementally
+	uint32_t m_nHeuristicKey;	// Extra heuristic state some heuristics need for that update (see Heuristic)
 	int m_nAction;			// Data Element, which is a string to hold an action ([0] = left, [1] = right, [2] = up, [3] = down. )
+	int m_nDepth;			// Parent's depth + 1, 1 at the root
 	Node* m_pParent;		//ptrs to parent node (may be NULL)
 };
 
 //Root Node constructor
-Node::Node(int state[9]) : m_nTotalCost(0), m_nAction(-1), m_pParent(nullptr)
+Node::Node(PackedState state) : m_State(state), m_nTotalCost(0), m_nHeuristic(0), m_nHeuristicKey(0), m_nAction(-1), m_nDepth(1), m_pParent(nullptr)
 {
-	for (int i = 0; i < 9; i++)
-		m_nState[i] = state[i];
 }
-//Child Node constructor
-Node::Node(int state[9], int action, Node* parent) : m_nTotalCost(0), m_nAction(action), m_pParent(parent)
+//Child Node constructor. The move is a shift/mask on the packed state.
+Node::Node(PackedState state, int action, Node* parent) : m_State(slidePackedTile(state, action)), m_nTotalCost(0), m_nHeuristic(0), m_nHeuristicKey(0), m_nAction(action), m_nDepth(parent->m_nDepth + 1), m_pParent(parent)
 {
-	for (int i = 0; i < 9; i++)
-		m_nState[i] = state[i];
-
-	int nTemp[3][3];
-	getMatrixState(nTemp);
-	slideTile(nTemp, action, 3);
-	getLinearFromMatrix(nTemp, 3, m_nState);
 }
 
-//Operator Overloads
-// < is used by priority queues, thus we need to tell them how to order the list with this operator overload
-//bool operator <(const Node &A, const Node &B)
-//{
-//	return A.m_nTotalCost < B.m_nTotalCost;
-//}
-
 //Accessors
-int* Node::getLinearState()
+PackedState Node::getState()
 {
-	return m_nState;
+	return m_State;
 }
 void Node::getLinearState(int container[9])
 {
-	for (int i = 0; i < 9; i++)
-		container[i] = m_nState[i];
+	unpackState(m_State, container);
 }
 void Node::getMatrixState(int container[3][3])
 {
-	container[0][0] = m_nState[0];
-	container[0][1] = m_nState[1];
-	container[0][2] = m_nState[2];
-	container[1][0] = m_nState[3];
-	container[1][1] = m_nState[4];
-	container[1][2] = m_nState[5];
-	container[2][0] = m_nState[6];
-	container[2][1] = m_nState[7];
-	container[2][2] = m_nState[8];
+	unpackMatrix(m_State, container);
 }
 
-//Return the depth of the node by following the parent pointer up to the root
+//Return the depth of the node, set from the parent's when it was made
 int Node::getDepth()
 {
-	int nDepth = 0;
-	Node *pNode = this;
-	while (pNode != nullptr)
-	{
-		nDepth++;
-		pNode = pNode->getParent();
-	}
-	return nDepth;
+	return m_nDepth;
 }
 
 int Node::getTotalCost()
 {
 	return m_nTotalCost;
 }
+int Node::getHeuristic()
+{
+	return m_nHeuristic;
+}
+uint32_t Node::getHeuristicKey()
+{
+	return m_nHeuristicKey;
+}
 int Node::getAction()
 {
 	return m_nAction;
@@ -113,22 +95,14 @@ Node* Node::getParent()
 {
 	return m_pParent;
 }
-Node* Node::getSelf()
-{
-	return this;
-}
 
 //Mutators
 void Node::setTotalCost(int cost)
 {
 	m_nTotalCost = cost;
 }
-
-class Compare
+void Node::setHeuristic(int h, uint32_t key)
 {
-public:
-	bool operator() (Node *A, Node *B)
-	{
-		return A->getTotalCost() < B->getTotalCost();
-	}
-};
\ No newline at end of file
+	m_nHeuristic = h;
+	m_nHeuristicKey = key;
+}
@@ -0,0 +1,146 @@
+/////////////////////////////////////////////////////////////
+// Node arena for eight_tile_solver.
+//
+// Hands out fixed-size node slots from large blocks so a search performs a
+// handful of heap allocations instead of one per child. Nothing is freed
+// node by node: releaseAll() recycles every slot in one operation (blocks
+// are kept for the next search) and the destructor returns the blocks to
+// the heap. Nodes are trivially destructible, so no destructors are run.
+// The pool is templated on the state type S and node type T; NodePool is
+// the 3x3 engines' pool and nxn_search.h pools BoardNode<N>.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <new>
+#include <vector>
+#include "node.h"
+
+using namespace std;
+
+template<class S, class T>
+class BasicNodePool
+{
+public:
+	BasicNodePool(unsigned int nNodesPerBlock = 16384);
+	~BasicNodePool();
+	T* createNode(const S &state);							//Root node, see the node's constructors
+	T* createNode(const S &state, int action, T* parent);	//Child node, see the node's constructors
+	void releaseLast();						//Returns the most recently created node to the pool
+	void releaseAll();						//Returns every node to the pool, keeping the blocks
+	void resetPeak();						//Restarts the high water mark from the nodes in use
+	unsigned int getNodesInUse();			//Accessors..
+	unsigned int getPeakNodesInUse();
+	size_t getBytesReserved();				//Bytes held in blocks
+	size_t getPeakBytesUsed();				//High water mark of bytes handed out as nodes
+
+protected:
+	T* allocateSlot();						//Returns the next free slot, adding a block if needed
+
+	vector<T*> m_vBlocks;
+	unsigned int m_nNodesPerBlock;
+	unsigned int m_nBlock;		// Index of the block slots are currently taken from
+	unsigned int m_nSlot;		// Next free slot within that block
+	unsigned int m_nInUse;
+	unsigned int m_nPeakInUse;
+
+private:
+	BasicNodePool(const BasicNodePool &);	//Not copyable, the pool owns its blocks
+	BasicNodePool &operator =(const BasicNodePool &);
+};
+
+typedef BasicNodePool<PackedState, Node> NodePool;	// The 3x3 engines' pool
+
+//Constructor. No block is allocated until the first node is requested.
+template<class S, class T>
+BasicNodePool<S, T>::BasicNodePool(unsigned int nNodesPerBlock) : m_nNodesPerBlock(nNodesPerBlock), m_nBlock(0), m_nSlot(0), m_nInUse(0), m_nPeakInUse(0)
+{
+}
+
+//Destructor. Frees every block; any node still referenced is invalid afterwards.
+template<class S, class T>
+BasicNodePool<S, T>::~BasicNodePool()
+{
+	for (unsigned int i = 0; i < m_vBlocks.size(); i++)
+		::operator delete(m_vBlocks[i]);
+}
+
+template<class S, class T>
+T* BasicNodePool<S, T>::createNode(const S &state)
+{
+	return new (allocateSlot()) T(state);
+}
+
+template<class S, class T>
+T* BasicNodePool<S, T>::createNode(const S &state, int action, T* parent)
+{
+	return new (allocateSlot()) T(state, action, parent);
+}
+
+//Returns the next free slot, moving to (or allocating) the next block when the current one is full
+template<class S, class T>
+T* BasicNodePool<S, T>::allocateSlot()
+{
+	if (m_nBlock < m_vBlocks.size() && m_nSlot == m_nNodesPerBlock)
+	{
+		m_nBlock++;
+		m_nSlot = 0;
+	}
+	if (m_nBlock == m_vBlocks.size())
+		m_vBlocks.push_back(static_cast<T*>(::operator new(sizeof(T) * m_nNodesPerBlock)));
+
+	m_nInUse++;
+	if (m_nInUse > m_nPeakInUse)
+		m_nPeakInUse = m_nInUse;
+	return m_vBlocks[m_nBlock] + m_nSlot++;
+}
+
+//Returns the most recently created node to the pool, e.g. a child found to be a duplicate
+template<class S, class T>
+void BasicNodePool<S, T>::releaseLast()
+{
+	if (m_nSlot == 0)
+		return;
+	m_nSlot--;
+	m_nInUse--;
+}
+
+//Bulk release. Every node handed out so far becomes invalid.
+template<class S, class T>
+void BasicNodePool<S, T>::releaseAll()
+{
+	m_nBlock = 0;
+	m_nSlot = 0;
+	m_nInUse = 0;
+}
+
+//Lets a caller measure the peak of a single search on a reused pool
+template<class S, class T>
+void BasicNodePool<S, T>::resetPeak()
+{
+	m_nPeakInUse = m_nInUse;
+}
+
+//Accessors
+template<class S, class T>
+unsigned int BasicNodePool<S, T>::getNodesInUse()
+{
+	return m_nInUse;
+}
+template<class S, class T>
+unsigned int BasicNodePool<S, T>::getPeakNodesInUse()
+{
+	return m_nPeakInUse;
+}
+template<class S, class T>
+size_t BasicNodePool<S, T>::getBytesReserved()
+{
+	return m_vBlocks.size() * m_nNodesPerBlock * sizeof(T);
+}
+template<class S, class T>
+size_t BasicNodePool<S, T>::getPeakBytesUsed()
+{
+	return m_nPeakInUse * sizeof(T);
+}
@@ -0,0 +1,296 @@
+/////////////////////////////////////////////////////////////
+// NxN board states for eight_tile_solver.
+//
+// The same packed representation as packed_state.h, generalized to any board
+// dimension N fixed at compile time: tiles are packed into BoardTraits<N>::WORDS
+// 64-bit words at 4 bits per tile for N <= 4 (one word for the 15-puzzle) and
+// 8 bits per tile for N = 5 (four words for the 24-puzzle), with the blank's
+// position cached. Move targets, legal move lists and position distances come
+// from constexpr tables built per size, so no operation checks the size at
+// runtime and a search loops over a blank's legal moves instead of testing four.
+// Moves keep the 3x3 numbering: [0] = left, [1] = right, [2] = up, [3] = down,
+// named for the direction the tile next to the blank slides.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <cctype>
+
+using namespace std;
+
+//Sizes that follow from the board dimension
+template<int N>
+struct BoardTraits
+{
+	static const int SIZE = N * N;									// Positions on the board
+	static const int BITS_PER_TILE = (N <= 4) ? 4 : 8;					// Bits per packed tile
+	static const int TILES_PER_WORD = 64 / BITS_PER_TILE;
+	static const int WORDS = (SIZE + TILES_PER_WORD - 1) / TILES_PER_WORD;
+	static const uint64_t BOARD_TILE_MASK = (1ULL << BITS_PER_TILE) - 1;
+};
+
+//Legal moves from one blank position
+struct BoardMoves
+{
+	int m_nCount;		// 2 in a corner, 3 on an edge, 4 inside
+	int m_nMoves[4];	// The legal moves, in the order [0] = left, [1] = right, [2] = up, [3] = down
+};
+
+//Per-size lookup tables, filled at compile time
+template<int N>
+struct BoardTables
+{
+	int m_nMoveTarget[N * N][4];	// [blank][move] = position of the tile that slides into the blank, -1 if illegal
+	BoardMoves m_Moves[N * N];		// [blank] = its legal moves
+	int m_nDistance[N * N][N * N];	// [p][q] = row distance + column distance between p and q
+};
+
+template<int N>
+struct BoardState
+{
+	uint64_t m_nWords[BoardTraits<N>::WORDS];	// Position p in word p / TILES_PER_WORD
+	int m_nBlank;								// Linear position of the blank tile
+};
+
+template<int N> constexpr BoardTables<N> makeBoardTables(); //Builds the move and distance tables for size N
+template<int N> BoardState<N> packBoard(const int tiles[N * N]); //Packs a linear state (ex: 1,2,...,15,0)
+template<int N> void unpackBoard(const BoardState<N> &state, int tiles[N * N]);
+template<int N> int getBoardTile(const BoardState<N> &state, int position);
+template<int N> bool isBoardMoveLegal(const BoardState<N> &state, int move); //[0] = left, [1] = right, [2] = up, [3] = down
+template<int N> const BoardMoves &getBoardMoves(const BoardState<N> &state); //Returns the legal moves from state's blank position
+template<int N> BoardState<N> slideBoardTile(const BoardState<N> &state, int move); //Returns the state after making move. Move must be legal
+template<int N> int getBoardParity(const BoardState<N> &state); //Two boards are reachable from each other iff their parities match
+template<int N> BoardState<N> getDefaultGoal(); //1, 2, ..., N*N-1 with the blank last
+template<int N> bool parseBoardString(string input, BoardState<N> &state); //Comma separated tiles, or one hex digit per tile when N <= 4
+template<int N> uint64_t getBoardHash(const BoardState<N> &state);
+template<int N> bool operator ==(const BoardState<N> &A, const BoardState<N> &B);
+template<int N> bool operator !=(const BoardState<N> &A, const BoardState<N> &B);
+
+//Move targets follow the 3x3 code: left brings in the tile right of the blank,
+//right the tile to its left, up the tile below and down the tile above
+template<int N>
+constexpr BoardTables<N> makeBoardTables()
+{
+	BoardTables<N> tables = {};
+	for (int p = 0; p < N * N; p++)
+	{
+		int nRow = p / N;
+		int nCol = p % N;
+		tables.m_nMoveTarget[p][0] = (nCol < N - 1) ? p + 1 : -1;
+		tables.m_nMoveTarget[p][1] = (nCol > 0) ? p - 1 : -1;
+		tables.m_nMoveTarget[p][2] = (nRow < N - 1) ? p + N : -1;
+		tables.m_nMoveTarget[p][3] = (nRow > 0) ? p - N : -1;
+		for (int move = 0; move < 4; move++)
+		{
+			if (tables.m_nMoveTarget[p][move] >= 0)
+				tables.m_Moves[p].m_nMoves[tables.m_Moves[p].m_nCount++] = move;
+		}
+		for (int q = 0; q < N * N; q++)
+		{
+			int nRows = nRow - q / N;
+			int nCols = nCol - q % N;
+			tables.m_nDistance[p][q] = (nRows < 0 ? -nRows : nRows) + (nCols < 0 ? -nCols : nCols);
+		}
+	}
+	return tables;
+}
+
+//The tables for size N, one copy per size
+template<int N>
+struct BoardConstants
+{
+	static constexpr BoardTables<N> s_Tables = makeBoardTables<N>();
+};
+template<int N> constexpr BoardTables<N> BoardConstants<N>::s_Tables;
+
+template<int N>
+BoardState<N> packBoard(const int tiles[N * N])
+{
+	typedef BoardTraits<N> T;
+	BoardState<N> state;
+	for (int w = 0; w < T::WORDS; w++)
+		state.m_nWords[w] = 0;
+	state.m_nBlank = 0;
+	for (int p = 0; p < T::SIZE; p++)
+	{
+		state.m_nWords[p / T::TILES_PER_WORD] |= (uint64_t)tiles[p] << ((p % T::TILES_PER_WORD) * T::BITS_PER_TILE);
+		if (tiles[p] == 0)
+			state.m_nBlank = p;
+	}
+	return state;
+}
+
+template<int N>
+void unpackBoard(const BoardState<N> &state, int tiles[N * N])
+{
+	for (int p = 0; p < N * N; p++)
+		tiles[p] = getBoardTile(state, p);
+}
+
+template<int N>
+int getBoardTile(const BoardState<N> &state, int position)
+{
+	typedef BoardTraits<N> T;
+	return (int)((state.m_nWords[position / T::TILES_PER_WORD] >> ((position % T::TILES_PER_WORD) * T::BITS_PER_TILE)) & T::BOARD_TILE_MASK);
+}
+
+template<int N>
+bool isBoardMoveLegal(const BoardState<N> &state, int move)
+{
+	return BoardConstants<N>::s_Tables.m_nMoveTarget[state.m_nBlank][move] >= 0;
+}
+
+//Returns the legal moves from state, so a search can loop over them instead of testing all four
+template<int N>
+const BoardMoves &getBoardMoves(const BoardState<N> &state)
+{
+	return BoardConstants<N>::s_Tables.m_Moves[state.m_nBlank];
+}
+
+//The blank's field holds 0, so the tile is or'ed into it and cleared from its old field
+template<int N>
+BoardState<N> slideBoardTile(const BoardState<N> &state, int move)
+{
+	typedef BoardTraits<N> T;
+	int nTarget = BoardConstants<N>::s_Tables.m_nMoveTarget[state.m_nBlank][move];
+	uint64_t nTile = (uint64_t)getBoardTile(state, nTarget);
+
+	BoardState<N> next = state;
+	next.m_nWords[nTarget / T::TILES_PER_WORD] &= ~(T::BOARD_TILE_MASK << ((nTarget % T::TILES_PER_WORD) * T::BITS_PER_TILE));
+	next.m_nWords[state.m_nBlank / T::TILES_PER_WORD] |= nTile << ((state.m_nBlank % T::TILES_PER_WORD) * T::BITS_PER_TILE);
+	next.m_nBlank = nTarget;
+	return next;
+}
+
+//Inversion parity of the tiles in reading order, ignoring the blank. On boards of
+//even width a vertical move jumps a tile over an odd number of others, flipping that
+//parity, so the blank's row is added in to keep the value invariant under moves.
+//Counted with one XOR per tile and a single bit count, as getStateParity does for 3x3.
+template<int N>
+int getBoardParity(const BoardState<N> &state)
+{
+	uint32_t nSeen = 0; //bit t set once tile t has been read
+	uint32_t nLarger = 0;
+	for (int i = 0; i < N * N; i++)
+	{
+		int nTile = getBoardTile<N>(state, i);
+		nLarger ^= nSeen >> nTile;
+		nSeen |= 1u << nTile;
+	}
+
+	//Count the bits of nLarger; the blank (as tile 0) added one inversion per tile before it
+	nLarger = nLarger - ((nLarger >> 1) & 0x55555555);
+	nLarger = (nLarger & 0x33333333) + ((nLarger >> 2) & 0x33333333);
+	nLarger = (nLarger + (nLarger >> 4)) & 0x0F0F0F0F;
+	int nParity = (int)((nLarger * 0x01010101) >> 24) + state.m_nBlank;
+	if (N % 2 == 0)
+		nParity += state.m_nBlank / N;
+	return nParity & 1;
+}
+
+template<int N>
+BoardState<N> getDefaultGoal()
+{
+	int nTiles[N * N];
+	for (int p = 0; p < N * N; p++)
+		nTiles[p] = (p + 1) % (N * N);
+	return packBoard<N>(nTiles);
+}
+
+//Parses tiles separated by commas (ex: 1,2,3,...), or, on boards of 16 or fewer
+//positions, one hex digit per tile (ex: 123456789ABCDEF0). Each tile 0 to N*N-1
+//must appear exactly once.
+template<int N>
+bool parseBoardString(string input, BoardState<N> &state)
+{
+	int nTiles[N * N];
+	int nCount = 0;
+	if (input.find(',') != string::npos || N * N > 16)
+	{
+		size_t nStart = 0;
+		while (nStart <= input.size())
+		{
+			size_t nEnd = input.find(',', nStart);
+			if (nEnd == string::npos)
+				nEnd = input.size();
+			if (nEnd == nStart || nEnd - nStart > 2 || nCount == N * N)
+				return false;
+			int nTile = 0;
+			for (size_t i = nStart; i < nEnd; i++)
+			{
+				if (input[i] < '0' || input[i] > '9')
+					return false;
+				nTile = nTile * 10 + (input[i] - '0');
+			}
+			nTiles[nCount++] = nTile;
+			nStart = nEnd + 1;
+		}
+	}
+	else
+	{
+		if (input.size() != N * N)
+			return false;
+		for (int i = 0; i < N * N; i++)
+		{
+			char ch = (char)toupper(input[i]);
+			if (ch >= '0' && ch <= '9')
+				nTiles[i] = ch - '0';
+			else if (ch >= 'A' && ch <= 'F')
+				nTiles[i] = ch - 'A' + 10;
+			else
+				return false;
+		}
+		nCount = N * N;
+	}
+
+	if (nCount != N * N)
+		return false;
+	uint64_t nSeen = 0;
+	for (int i = 0; i < N * N; i++)
+	{
+		if (nTiles[i] >= N * N || (nSeen & (1ULL << nTiles[i])))
+			return false;
+		nSeen |= 1ULL << nTiles[i];
+	}
+	state = packBoard<N>(nTiles);
+	return true;
+}
+
+//Each word goes through the fmix64 finalizer used by getStateHash, chained through the next
+template<int N>
+uint64_t getBoardHash(const BoardState<N> &state)
+{
+	uint64_t nHash = 0;
+	for (int w = 0; w < BoardTraits<N>::WORDS; w++)
+	{
+		nHash ^= state.m_nWords[w];
+		nHash ^= nHash >> 33;
+		nHash *= 0xFF51AFD7ED558CCDULL;
+		nHash ^= nHash >> 33;
+		nHash *= 0xC4CEB9FE1A85EC53ULL;
+		nHash ^= nHash >> 33;
+	}
+	return nHash;
+}
+
+//The blank is implied by the tiles, so only they are compared
+template<int N>
+bool operator ==(const BoardState<N> &A, const BoardState<N> &B)
+{
+	for (int w = 0; w < BoardTraits<N>::WORDS; w++)
+	{
+		if (A.m_nWords[w] != B.m_nWords[w])
+			return false;
+	}
+	return true;
+}
+
+template<int N>
+bool operator !=(const BoardState<N> &A, const BoardState<N> &B)
+{
+	return !(A == B);
+}
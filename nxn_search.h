@@ -0,0 +1,358 @@
+/////////////////////////////////////////////////////////////
+// NxN search engines for eight_tile_solver.
+//
+// IDA* and A* over BoardState<N> (see nxn_board.h), templated on the board
+// dimension and on the heuristic, so the 15- and 24-puzzle run through the
+// same code as the 8-puzzle with every table sized at compile time.
+// A heuristic class provides:
+//   BoardState<N> getGoal();
+//   int evaluate(const BoardState<N> &state);
+//   int getChildValue(const BoardState<N> &parent, int h, const BoardState<N> &child);
+// BoardManhattan<N> is the default; getChildValue updates h from the one tile
+// that slides. IDA* is the engine for the larger boards, where the open list of
+// A* outgrows memory on hard instances. A* keeps its BoardNode<N> nodes and
+// visited states in the same pool and table as the 3x3 engines (see
+// node_pool.h and visited_set.h), templated on the board.
+// Does no console output. Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <limits.h>
+#include <vector>
+#include <algorithm>
+#include "nxn_board.h"
+#include "search_stats.h"
+#include "bucket_queue.h"
+#include "move_string.h"
+#include "node_pool.h"
+#include "visited_set.h"
+
+using namespace std;
+
+#define BOARD_FOUND -1				// Returned by a bounded IDA* search that reached the goal
+
+//Manhattan distance for size N. Costs are looked up per tile and position
+template<int N>
+class BoardManhattan
+{
+public:
+	void build(const BoardState<N> &goal);
+	BoardState<N> getGoal();
+	int evaluate(const BoardState<N> &state);
+	int getChildValue(const BoardState<N> &parent, int h, const BoardState<N> &child);
+
+protected:
+	BoardState<N> m_Goal;
+	int m_nCost[N * N][N * N];	// [tile][position] = distance from position to the tile's goal position. The blank costs 0
+};
+
+//A* search node, as Node is for 3x3 (see node.h)
+template<int N>
+class BoardNode
+{
+public:
+	BoardNode(const BoardState<N> &state);									//Root node constructor
+	BoardNode(const BoardState<N> &state, int action, BoardNode* parent);	//Child node constructor. Does action to state in constructor
+	const BoardState<N> &getState();		//Accessors..
+	int getAction();
+	int getDepth();							//Returns the depth of the node, 1 at the root. Path cost g is getDepth() - 1
+	int getHeuristic();
+	BoardNode* getParent();
+	void setHeuristic(int h);
+
+protected:
+	BoardState<N> m_State;
+	int m_nHeuristic;		// h of this state, kept so a child's h can be updated from it incrementally
+	int m_nAction;			// Move that made this node from its parent, -1 at the root
+	int m_nDepth;			// Parent's depth + 1, 1 at the root
+	BoardNode* m_pParent;
+};
+
+//Reusable working memory for solveBoardAStar, as SearchContext is for 3x3. Keep one
+//per thread so blocks and slots are allocated once rather than per puzzle.
+template<int N>
+struct BoardSearchContext
+{
+	BasicNodePool< BoardState<N>, BoardNode<N> > m_Pool;
+	BasicVisitedSet< BoardState<N>, BoardNode<N> > m_Visited;
+	BucketQueue< BoardNode<N>* > m_OpenList;	// By f, then deepest first
+};
+
+//One IDA* search: the single board moves are made and unmade on, plus the path so far
+template<int N, class H>
+struct BoardIDAStarContext
+{
+	BoardState<N> m_State;
+	BoardState<N> m_Goal;
+	H *m_pHeuristic;
+	MoveString m_Path;
+	SearchStats *m_pStats;
+};
+
+template<int N, class H> bool solveBoardIDAStar(const BoardState<N> &start, H &heuristic, MoveString &path, SearchStats &stats); //Optimal if h is admissible. Returns false if unsolvable
+template<int N, class H> int searchBoardIDAStarBound(BoardIDAStarContext<N, H> &ctx, int g, int h, int nBound, int nLastMove); //Returns BOARD_FOUND or the smallest f over the bound
+template<int N, class H> bool solveBoardAStar(const BoardState<N> &start, H &heuristic, BoardSearchContext<N> &ctx, MoveString &path, SearchStats &stats); //Optimal if h is admissible. Returns false if unsolvable
+
+template<int N>
+void BoardManhattan<N>::build(const BoardState<N> &goal)
+{
+	m_Goal = goal;
+	for (int g = 0; g < N * N; g++)
+	{
+		int nTile = getBoardTile(goal, g);
+		for (int p = 0; p < N * N; p++)
+			m_nCost[nTile][p] = (nTile == 0) ? 0 : BoardConstants<N>::s_Tables.m_nDistance[p][g];
+	}
+}
+
+template<int N>
+BoardState<N> BoardManhattan<N>::getGoal()
+{
+	return m_Goal;
+}
+
+template<int N>
+int BoardManhattan<N>::evaluate(const BoardState<N> &state)
+{
+	int h = 0;
+	for (int p = 0; p < N * N; p++)
+		h += m_nCost[getBoardTile(state, p)][p];
+	return h;
+}
+
+//The tile that moved now sits where the parent's blank was
+template<int N>
+int BoardManhattan<N>::getChildValue(const BoardState<N> &parent, int h, const BoardState<N> &child)
+{
+	int nTile = getBoardTile(child, parent.m_nBlank);
+	return h + m_nCost[nTile][parent.m_nBlank] - m_nCost[nTile][child.m_nBlank];
+}
+
+//Root BoardNode constructor
+template<int N>
+BoardNode<N>::BoardNode(const BoardState<N> &state) : m_State(state), m_nHeuristic(0), m_nAction(-1), m_nDepth(1), m_pParent(nullptr)
+{
+}
+//Child BoardNode constructor
+template<int N>
+BoardNode<N>::BoardNode(const BoardState<N> &state, int action, BoardNode* parent) : m_State(slideBoardTile(state, action)), m_nHeuristic(0), m_nAction(action), m_nDepth(parent->m_nDepth + 1), m_pParent(parent)
+{
+}
+
+//Accessors
+template<int N>
+const BoardState<N> &BoardNode<N>::getState()
+{
+	return m_State;
+}
+template<int N>
+int BoardNode<N>::getAction()
+{
+	return m_nAction;
+}
+template<int N>
+int BoardNode<N>::getDepth()
+{
+	return m_nDepth;
+}
+template<int N>
+int BoardNode<N>::getHeuristic()
+{
+	return m_nHeuristic;
+}
+template<int N>
+BoardNode<N>* BoardNode<N>::getParent()
+{
+	return m_pParent;
+}
+
+//Mutators
+template<int N>
+void BoardNode<N>::setHeuristic(int h)
+{
+	m_nHeuristic = h;
+}
+
+//Fills path with a solution toward heuristic's goal, as solveIDAStar does for 3x3
+template<int N, class H>
+bool solveBoardIDAStar(const BoardState<N> &start, H &heuristic, MoveString &path, SearchStats &stats)
+{
+	path.clear();
+	clearSearchStats(stats);
+	BoardState<N> goal = heuristic.getGoal();
+	if (getBoardParity(start) != getBoardParity(goal))
+		return false; //unreachable, every iteration would fail
+
+	BoardIDAStarContext<N, H> ctx;
+	ctx.m_State = start;
+	ctx.m_Goal = goal;
+	ctx.m_pHeuristic = &heuristic;
+	ctx.m_pStats = &stats;
+	ctx.m_Path.reserve(256); //no 24-puzzle solution is longer than 208 moves
+
+	int h = heuristic.evaluate(start);
+	stats.m_nHeuristicEvaluations++;
+	int nBound = h;
+	while (true)
+	{
+		int nResult = searchBoardIDAStarBound(ctx, 0, h, nBound, -1);
+		if (nResult == BOARD_FOUND)
+			break;
+		nBound = nResult;
+	}
+
+	path = ctx.m_Path;
+	return true;
+}
+
+//Depth first search cutting off any node with g + h > nBound. See searchIDAStarBound
+template<int N, class H>
+int searchBoardIDAStarBound(BoardIDAStarContext<N, H> &ctx, int g, int h, int nBound, int nLastMove)
+{
+	int f = g + h;
+	if (f > nBound)
+	{
+		ctx.m_pStats->m_nPruned++;
+		return f;
+	}
+	if (ctx.m_State == ctx.m_Goal)
+		return BOARD_FOUND;
+
+	SearchStats &stats = *ctx.m_pStats;
+	stats.m_nExpanded++;
+	int nMin = INT_MAX;
+	const BoardMoves &moves = getBoardMoves(ctx.m_State); //legal moves from this blank position
+	for (int i = 0; i < moves.m_nCount; i++)
+	{
+		//Skip the move that undoes the last one ([0]<->[1], [2]<->[3])
+		int move = moves.m_nMoves[i];
+		if (move == (nLastMove ^ 1))
+			continue;
+
+		BoardState<N> parent = ctx.m_State;
+		{
+			PhaseTimer timer(stats, PHASE_EXPAND);
+			ctx.m_State = slideBoardTile(parent, move);
+			ctx.m_Path.push_back(move);
+		}
+		int nChildH;
+		{
+			PhaseTimer timer(stats, PHASE_HEURISTIC);
+			nChildH = ctx.m_pHeuristic->getChildValue(parent, h, ctx.m_State);
+		}
+		stats.m_nGenerated++;
+		stats.m_nHeuristicEvaluations++;
+		updateSearchPeak(stats.m_nPeakOpen, ctx.m_Path.size());
+
+		int nResult = searchBoardIDAStarBound(ctx, g + 1, nChildH, nBound, move);
+		if (nResult == BOARD_FOUND)
+			return BOARD_FOUND;
+		if (nResult < nMin)
+			nMin = nResult;
+
+		ctx.m_Path.pop_back();
+		ctx.m_State = parent;
+	}
+	return nMin;
+}
+
+//A* with re-opening and lazy deletion, as solveBestFirst does for 3x3. Every node lives
+//in ctx's pool until the next search; the visited set holds each state's best node.
+template<int N, class H>
+bool solveBoardAStar(const BoardState<N> &start, H &heuristic, BoardSearchContext<N> &ctx, MoveString &path, SearchStats &stats)
+{
+	path.clear();
+	clearSearchStats(stats);
+	BoardState<N> goal = heuristic.getGoal();
+	if (getBoardParity(start) != getBoardParity(goal))
+		return false;
+
+	BasicNodePool< BoardState<N>, BoardNode<N> > &pool = ctx.m_Pool;
+	BasicVisitedSet< BoardState<N>, BoardNode<N> > &visited = ctx.m_Visited; //open + closed, with each state's best node
+	BucketQueue< BoardNode<N>* > &qOpenList = ctx.m_OpenList;
+	pool.releaseAll();
+	visited.clear();
+	qOpenList.clear();
+
+	BoardNode<N>* node = pool.createNode(start);
+	node->setHeuristic(heuristic.evaluate(start));
+	stats.m_nHeuristicEvaluations++;
+	visited.insert(start, node);
+	qOpenList.push(node, node->getHeuristic(), 0);
+
+	while (!qOpenList.empty())
+	{
+		{
+			PhaseTimer timer(stats, PHASE_QUEUE);
+			node = qOpenList.top();
+			qOpenList.pop();
+		}
+		const BoardState<N> &state = node->getState();
+		{
+			PhaseTimer timer(stats, PHASE_DUPLICATE);
+			if (visited.find(state) != node)
+				continue; //superseded by a cheaper path
+		}
+
+		if (state == goal)
+		{
+			stats.m_nPeakClosed = visited.getSize();
+			getPathMoves(node, path);
+			return true;
+		}
+
+		stats.m_nExpanded++;
+		int nChildDepth = node->getDepth() + 1;
+		const BoardMoves &moves = getBoardMoves(state);
+		for (int i = 0; i < moves.m_nCount; i++)
+		{
+			int move = moves.m_nMoves[i];
+			BoardState<N> childState;
+			{
+				PhaseTimer timer(stats, PHASE_EXPAND);
+				childState = slideBoardTile(state, move);
+			}
+			stats.m_nGenerated++;
+			BoardNode<N>* pBest;
+			{
+				PhaseTimer timer(stats, PHASE_DUPLICATE);
+				pBest = visited.find(childState);
+			}
+			if (pBest != nullptr && pBest->getDepth() <= nChildDepth)
+			{
+				stats.m_nDuplicates++;
+				continue;
+			}
+
+			BoardNode<N>* child;
+			{
+				PhaseTimer timer(stats, PHASE_EXPAND);
+				child = pool.createNode(state, move, node);
+			}
+			{
+				PhaseTimer timer(stats, PHASE_HEURISTIC);
+				child->setHeuristic(heuristic.getChildValue(state, node->getHeuristic(), childState));
+			}
+			stats.m_nHeuristicEvaluations++;
+			{
+				PhaseTimer timer(stats, PHASE_DUPLICATE);
+				if (pBest == nullptr)
+					visited.insert(childState, child);
+				else
+				{
+					visited.replace(childState, child); //re-open with the cheaper path
+					stats.m_nReopened++;
+				}
+			}
+
+			PhaseTimer timer(stats, PHASE_QUEUE);
+			qOpenList.push(child, nChildDepth + child->getHeuristic(), nChildDepth);
+			updateSearchPeak(stats.m_nPeakOpen, qOpenList.size());
+		}
+	}
+	stats.m_nPeakClosed = visited.getSize();
+	return false;
+}
@@ -0,0 +1,170 @@
+/////////////////////////////////////////////////////////////
+// Packed board state for eight_tile_solver.
+//
+// A board state is stored as 4 bits per tile in a single 64-bit word, with
+// the tile at linear position i (0..8) living in bits [4i, 4i+4). The
+// position of the blank is cached alongside so moves never scan the board.
+// Moves are done with shift/mask operations and equality is one compare.
+// The legal moves from each blank position come from a table built at compile
+// time, so successors are generated with no board scans, branches on the
+// blank's row and column, or allocation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+
+using namespace std;
+
+#define TILE_BITS 4
+#define TILE_MASK 0xFULL
+
+struct PackedState
+{
+	uint64_t m_nTiles;	// 4 bits per tile, position 0 in the lowest nibble
+	int m_nBlank;		// Linear position (0..8) of the blank tile
+};
+
+//Legal moves for one blank position
+struct PackedMoves
+{
+	int m_nCount;		// 2 in a corner, 3 on an edge, 4 in the center
+	int m_nMoves[4];	// The legal moves, in the order [0] = left, [1] = right, [2] = up, [3] = down
+};
+
+struct PackedMoveTable
+{
+	int m_nTarget[9][4];		// [blank][move] = position of the tile that slides into the blank, -1 if illegal
+	PackedMoves m_Moves[9];		// [blank] = its legal moves
+};
+
+PackedState packState(int state[9]); //Packs a linear state (ex: 1,2,3,4,5,6,7,8,0) into a PackedState
+PackedState packMatrix(int board[3][3]); //Packs a 3x3 matrix state into a PackedState
+void unpackState(PackedState state, int container[9]); //Populates container with the linear form of state
+void unpackMatrix(PackedState state, int container[3][3]); //Populates container with the matrix form of state
+int getPackedTile(PackedState state, int position); //Returns the tile at the given linear position
+bool isPackedMoveLegal(PackedState state, int move); //Returns true if move is legal. [0] = left, [1] = right, [2] = up, [3] = down.
+PackedState slidePackedTile(PackedState state, int move); //Returns the state after making move. Move must be legal.
+const PackedMoves &getPackedMoves(PackedState state); //Returns the legal moves from state's blank position
+constexpr PackedMoveTable makePackedMoveTable(); //Builds the move tables for every blank position
+uint64_t getStateHash(PackedState state); //Returns a well mixed 64-bit hash of the state
+bool operator ==(const PackedState &A, const PackedState &B);
+bool operator !=(const PackedState &A, const PackedState &B);
+
+//Left brings in the tile right of the blank, right the tile to its left, up the
+//tile below and down the tile above
+constexpr PackedMoveTable makePackedMoveTable()
+{
+	PackedMoveTable table = {};
+	for (int p = 0; p < 9; p++)
+	{
+		int nRow = p / 3;
+		int nCol = p % 3;
+		table.m_nTarget[p][0] = (nCol < 2) ? p + 1 : -1;
+		table.m_nTarget[p][1] = (nCol > 0) ? p - 1 : -1;
+		table.m_nTarget[p][2] = (nRow < 2) ? p + 3 : -1;
+		table.m_nTarget[p][3] = (nRow > 0) ? p - 3 : -1;
+		for (int move = 0; move < 4; move++)
+		{
+			if (table.m_nTarget[p][move] >= 0)
+				table.m_Moves[p].m_nMoves[table.m_Moves[p].m_nCount++] = move;
+		}
+	}
+	return table;
+}
+
+constexpr PackedMoveTable g_PackedMoveTable = makePackedMoveTable();
+
+//Packs a linear state into a PackedState
+PackedState packState(int state[9])
+{
+	PackedState packed;
+	packed.m_nTiles = 0;
+	packed.m_nBlank = 0;
+	for (int i = 0; i < 9; i++)
+	{
+		packed.m_nTiles |= (uint64_t)state[i] << (i * TILE_BITS);
+		if (state[i] == 0)
+			packed.m_nBlank = i;
+	}
+	return packed;
+}
+
+//Packs a 3x3 matrix state into a PackedState
+PackedState packMatrix(int board[3][3])
+{
+	int nTemp[9];
+	for (int i = 0; i < 9; i++)
+		nTemp[i] = board[i / 3][i % 3];
+	return packState(nTemp);
+}
+
+//Populates container with the linear form of state
+void unpackState(PackedState state, int container[9])
+{
+	for (int i = 0; i < 9; i++)
+		container[i] = getPackedTile(state, i);
+}
+
+//Populates container with the matrix form of state
+void unpackMatrix(PackedState state, int container[3][3])
+{
+	for (int i = 0; i < 9; i++)
+		container[i / 3][i % 3] = getPackedTile(state, i);
+}
+
+//Returns the tile at the given linear position
+int getPackedTile(PackedState state, int position)
+{
+	return (int)((state.m_nTiles >> (position * TILE_BITS)) & TILE_MASK);
+}
+
+//Determines legality of a move from the cached blank position.
+//Legal values for move are [0] = left, [1] = right, [2] = up, [3] = down.
+bool isPackedMoveLegal(PackedState state, int move)
+{
+	return g_PackedMoveTable.m_nTarget[state.m_nBlank][move] >= 0;
+}
+
+//Returns the legal moves from state, so a search can loop over them instead of testing all four
+const PackedMoves &getPackedMoves(PackedState state)
+{
+	return g_PackedMoveTable.m_Moves[state.m_nBlank];
+}
+
+//Make a move on the packed state. The tile next to the blank is moved into the
+//blank's nibble and its own nibble is cleared, which makes it the new blank.
+//Move must be legal (see isPackedMoveLegal).
+PackedState slidePackedTile(PackedState state, int move)
+{
+	int nTarget = g_PackedMoveTable.m_nTarget[state.m_nBlank][move];
+	uint64_t nTile = (state.m_nTiles >> (nTarget * TILE_BITS)) & TILE_MASK;
+
+	PackedState child;
+	child.m_nTiles = (state.m_nTiles & ~(TILE_MASK << (nTarget * TILE_BITS))) | (nTile << (state.m_nBlank * TILE_BITS));
+	child.m_nBlank = nTarget;
+	return child;
+}
+
+//Returns a well mixed 64-bit hash of the state (the blank is implied by the tiles)
+uint64_t getStateHash(PackedState state)
+{
+	uint64_t nHash = state.m_nTiles;
+	nHash ^= nHash >> 33;
+	nHash *= 0xFF51AFD7ED558CCDULL;
+	nHash ^= nHash >> 33;
+	nHash *= 0xC4CEB9FE1A85EC53ULL;
+	nHash ^= nHash >> 33;
+	return nHash;
+}
+
+//Operator Overloads. The blank is implied by the tiles, so only they are compared.
+bool operator ==(const PackedState &A, const PackedState &B)
+{
+	return A.m_nTiles == B.m_nTiles;
+}
+bool operator !=(const PackedState &A, const PackedState &B)
+{
+	return A.m_nTiles != B.m_nTiles;
+}
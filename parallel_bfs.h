@@ -0,0 +1,180 @@
+/////////////////////////////////////////////////////////////
+// Level-synchronous parallel breadth first search for eight_tile_solver.
+//
+// The search runs one depth layer at a time. Each layer's frontier is cut
+// into tasks that every thread shares out by work stealing (see
+// work_stealing.h), and a thread claims each state it generates with an
+// atomic test-and-set on a bitmap indexed by state rank (see state_rank.h).
+// Only the thread that claims a state records its depth and adds it to the
+// next layer, so no state is expanded twice and depth bytes are never
+// written by two threads. Layers are separated by joining the threads, so a
+// state's depth is always its true BFS depth.
+// Does no console output. Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include "packed_state.h"
+#include "state_rank.h"
+#include "work_stealing.h"
+#include "move_string.h"
+
+using namespace std;
+
+#define BFS_UNREACHED 0xFF		// Depth of a state the search has not reached
+#define BFS_TASK_STATES 256		// Frontier states per work-stealing task
+
+//Visited bitmap that any number of threads may claim states in at once
+class AtomicVisitedBitmap
+{
+public:
+	AtomicVisitedBitmap();					//Starts with every bit clear
+	bool testAndSet(int rank);				//Sets the bit for rank. Returns false if it was already set, by any thread
+	bool test(int rank);
+	void clear();							//Not thread safe
+
+protected:
+	vector< atomic<uint64_t> > m_vWords;	// NUM_STATE_RANKS / 64 words
+};
+
+//Runs a BFS outward from root using nThreads threads (0 = one per hardware thread).
+//vDepths receives each rank's depth (BFS_UNREACHED if not reached) and vLayerSizes
+//the number of states at each depth. If stop is reached the search ends once its
+//layer is complete. Returns the number of states reached.
+unsigned int runParallelBFS(PackedState root, PackedState stop, unsigned int nThreads, vector<unsigned char> &vDepths, vector<unsigned int> &vLayerSizes);
+unsigned int runParallelBFS(PackedState root, unsigned int nThreads, vector<unsigned char> &vDepths, vector<unsigned int> &vLayerSizes); //Visits every state reachable from root
+unsigned int runParallelBFSLayers(PackedState root, int nStopRank, unsigned int nThreads, vector<unsigned char> &vDepths, vector<unsigned int> &vLayerSizes);
+bool solveParallelBFS(PackedState start, PackedState goal, unsigned int nThreads, MoveString &path); //Fills path with an optimal solution. Returns false if unsolvable
+
+AtomicVisitedBitmap::AtomicVisitedBitmap() : m_vWords(NUM_STATE_RANKS / 64)
+{
+	clear();
+}
+
+//Sets the bit for rank. fetch_or is a single atomic read-modify-write, so when
+//several threads race for one state exactly one of them sees the bit clear
+bool AtomicVisitedBitmap::testAndSet(int rank)
+{
+	uint64_t nBit = 1ULL << (rank & 63);
+	return (m_vWords[rank >> 6].fetch_or(nBit, memory_order_relaxed) & nBit) == 0;
+}
+
+bool AtomicVisitedBitmap::test(int rank)
+{
+	return (m_vWords[rank >> 6].load(memory_order_relaxed) >> (rank & 63)) & 1;
+}
+
+void AtomicVisitedBitmap::clear()
+{
+	for (unsigned int i = 0; i < m_vWords.size(); i++)
+		m_vWords[i].store(0, memory_order_relaxed);
+}
+
+unsigned int runParallelBFS(PackedState root, PackedState stop, unsigned int nThreads, vector<unsigned char> &vDepths, vector<unsigned int> &vLayerSizes)
+{
+	int nStopRank = (getStateParity(stop) == getStateParity(root)) ? rankState(stop) : -1;
+	return runParallelBFSLayers(root, nStopRank, nThreads, vDepths, vLayerSizes);
+}
+
+//Visits every state reachable from root
+unsigned int runParallelBFS(PackedState root, unsigned int nThreads, vector<unsigned char> &vDepths, vector<unsigned int> &vLayerSizes)
+{
+	return runParallelBFSLayers(root, -1, nThreads, vDepths, vLayerSizes);
+}
+
+//The search itself. nStopRank is the rank to stop at, -1 for none
+unsigned int runParallelBFSLayers(PackedState root, int nStopRank, unsigned int nThreads, vector<unsigned char> &vDepths, vector<unsigned int> &vLayerSizes)
+{
+	int nParity = getStateParity(root);
+	WorkStealingScheduler scheduler(nThreads);
+	AtomicVisitedBitmap visited;
+	vector<int> vFrontier;
+	vector< vector<int> > vNext(scheduler.getThreadCount()); //[nThread] = states that thread claimed for the next layer
+
+	vDepths.assign(NUM_STATE_RANKS, BFS_UNREACHED);
+	vLayerSizes.clear();
+	int nRootRank = rankState(root);
+	visited.testAndSet(nRootRank);
+	vDepths[nRootRank] = 0;
+	vFrontier.push_back(nRootRank);
+
+	unsigned int nReached = 0;
+	for (int nDepth = 1; !vFrontier.empty(); nDepth++)
+	{
+		vLayerSizes.push_back(vFrontier.size());
+		nReached += vFrontier.size();
+		if (nStopRank >= 0 && vDepths[nStopRank] != BFS_UNREACHED)
+			break;
+
+		//Expand the layer. The threads are joined before run returns, which
+		//orders every write of this layer before the next layer reads it
+		unsigned int nTasks = (unsigned int)((vFrontier.size() + BFS_TASK_STATES - 1) / BFS_TASK_STATES);
+		scheduler.run(nTasks, [&](unsigned int nThread, unsigned int nTask)
+		{
+			vector<int> &next = vNext[nThread];
+			size_t nLast = min(vFrontier.size(), (size_t)(nTask + 1) * BFS_TASK_STATES);
+			for (size_t i = (size_t)nTask * BFS_TASK_STATES; i < nLast; i++)
+			{
+				PackedState state = unrankState(vFrontier[i], nParity);
+				const PackedMoves &moves = getPackedMoves(state);
+				for (int m = 0; m < moves.m_nCount; m++)
+				{
+					int nRank = rankState(slidePackedTile(state, moves.m_nMoves[m]));
+					if (visited.testAndSet(nRank))
+					{
+						vDepths[nRank] = (unsigned char)nDepth; //only the claiming thread writes this byte
+						next.push_back(nRank);
+					}
+				}
+			}
+		});
+
+		//The claimed states, in any order, are the next layer
+		vFrontier.clear();
+		for (unsigned int t = 0; t < vNext.size(); t++)
+		{
+			vFrontier.insert(vFrontier.end(), vNext[t].begin(), vNext[t].end());
+			vNext[t].clear();
+		}
+	}
+	return nReached;
+}
+
+//Searches outward from goal until start's layer is complete, then walks from
+//start to ever smaller depths. Each move is its own inverse, so depths from the
+//goal are distances to it and the walk is an optimal solution.
+bool solveParallelBFS(PackedState start, PackedState goal, unsigned int nThreads, MoveString &path)
+{
+	path.clear();
+	if (getStateParity(start) != getStateParity(goal))
+		return false;
+
+	vector<unsigned char> vDepths;
+	vector<unsigned int> vLayerSizes;
+	runParallelBFS(goal, start, nThreads, vDepths, vLayerSizes);
+
+	PackedState state = start;
+	int nDepth = vDepths[rankState(state)];
+	while (nDepth > 0)
+	{
+		const PackedMoves &moves = getPackedMoves(state);
+		for (int m = 0; m < moves.m_nCount; m++)
+		{
+			int move = moves.m_nMoves[m];
+			PackedState next = slidePackedTile(state, move);
+			if (vDepths[rankState(next)] == nDepth - 1)
+			{
+				path.push_back(move);
+				state = next;
+				break;
+			}
+		}
+		nDepth--;
+	}
+	return true;
+}
@@ -0,0 +1,468 @@
+/////////////////////////////////////////////////////////////
+// Additive disjoint pattern databases for eight_tile_solver.
+//
+// The tiles of an NxN board are split into disjoint groups (ex: 6-6-3 on the
+// 15-puzzle). For each group a retrograde search from the goal finds, for
+// every placement of that group's tiles, the fewest moves OF THOSE TILES
+// needed to bring them home; moves of other tiles are free. Since no move is
+// counted by two groups, the per-group costs add up to an admissible
+// heuristic far stronger than Manhattan distance.
+//
+// A placement is indexed by the positions of the group's k tiles as a partial
+// permutation of the N*N positions, so a table has (N*N)!/(N*N-k)! one-byte
+// entries with no gaps (5,765,760 for 6 tiles of the 15-puzzle). Each table
+// is written to a file the first time it is needed and memory mapped from
+// then on (see mapped_file.h); an invalid file is deleted and rebuilt.
+//
+// File layout: PatternHeader, followed by one cost byte per placement.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include "nxn_board.h"
+#include "state_rank.h"
+#include "mapped_file.h"
+
+using namespace std;
+
+#define PDB_MAGIC "NPDB"
+#define PDB_VERSION 1
+#define PDB_UNREACHED 0xFF
+#define MAX_PATTERN_TILES 8		// Largest group; 8 tiles of the 15-puzzle is a 519 MB table
+#define MAX_PATTERN_BUILD_BYTES (2ULL << 30)	// Cap on a table plus its build's settled bits (see getMaxPatternTableSize)
+#define MAX_PATTERN_GROUPS 8	// 6-6-6-6 on the 24-puzzle, or up to 8 smaller groups
+
+struct PatternHeader
+{
+	char m_chMagic[4];			// PDB_MAGIC
+	uint32_t m_nVersion;		// PDB_VERSION
+	uint32_t m_nSize;			// Board dimension N
+	uint32_t m_nTileCount;		// k
+	uint8_t m_nTiles[MAX_PATTERN_TILES];		// The group's tiles
+	uint8_t m_nGoalPositions[MAX_PATTERN_TILES];	// Where each of them sits in the goal
+};
+
+template<int N>
+class PatternDatabase
+{
+public:
+	PatternDatabase();
+	bool open(const BoardState<N> &goal, const vector<int> &vTiles, string directory = "");	//Maps the group's table, generating the file first if needed
+	bool isOpen();
+	uint64_t getIndex(const BoardState<N> &state);	//Placement index of the group's tiles in state
+	int getCost(const BoardState<N> &state);		//Moves of the group's tiles needed to reach the goal
+
+protected:
+	bool mapFile(string path, const BoardState<N> &goal, const vector<int> &vTiles);	//Maps path if its header and size match the group's table
+
+	MappedFile m_File;
+	const unsigned char* m_pCosts;	// Points just past the header in the mapping
+	int m_nCount;					// k
+	int m_nSlot[N * N];				// [tile] = its index within the group, -1 if not in the group
+
+private:
+	PatternDatabase(const PatternDatabase &);	//Not copyable, the object owns the mapping
+	PatternDatabase &operator =(const PatternDatabase &);
+};
+
+//Sum of the group costs, usable by the NxN engines (see nxn_search.h)
+template<int N>
+class AdditivePatternHeuristic
+{
+public:
+	AdditivePatternHeuristic();
+	bool build(const BoardState<N> &goal, const vector< vector<int> > &vGroups, string directory = ""); //Opens or generates a table per group. Returns false on failure
+	BoardState<N> getGoal();
+	int evaluate(const BoardState<N> &state);
+	int getChildValue(const BoardState<N> &parent, int h, const BoardState<N> &child); //Only the moved tile's group is looked up again
+
+protected:
+	BoardState<N> m_Goal;
+	PatternDatabase<N> m_Databases[MAX_PATTERN_GROUPS];
+	int m_nGroups;
+	int m_nGroupOf[N * N];			// [tile] = its group, -1 for the blank
+};
+
+template<int N> string getPatternDatabaseName(const BoardState<N> &goal, const vector<int> &vTiles); //ex: pattern_4x4_1-5-6-9-10-13_<goal hash>.pdb
+template<int N> bool buildPatternDatabase(const BoardState<N> &goal, const vector<int> &vTiles, string path); //Runs the retrograde search and writes the table to path, through a temp file
+template<int N> uint64_t getPatternTableSize(int nTiles); //(N*N)! / (N*N-k)!
+template<int N> uint64_t getMaxPatternTableSize(); //Most placements a table may have on an NxN board
+template<int N> int getMaxPatternTiles(); //Largest group whose table fits getMaxPatternTableSize: 8 for 4x4, 6 for 5x5
+template<int N> bool getDefaultPatternGroups(vector< vector<int> > &vGroups); //6-6-3 for 4x4, 6-6-6-6 for 5x5
+bool parsePatternGroups(string input, vector< vector<int> > &vGroups); //Groups separated by '/', tiles by ',' (ex: 1,2,3/4,5,6)
+uint64_t rankPlacement(const int nPositions[], int nCount, int nBoardSize); //Index of a partial permutation of positions
+void unrankPlacement(uint64_t nIndex, int nCount, int nBoardSize, int nPositions[]); //Inverse of rankPlacement
+
+//Partial permutation rank: each position is numbered among the positions not
+//taken by the tiles before it, giving digits of radix n, n-1, ..., n-k+1.
+//64 bits wide, since 8 tiles of the 24-puzzle already have 25!/17! placements
+uint64_t rankPlacement(const int nPositions[], int nCount, int nBoardSize)
+{
+	uint32_t nUsed = 0;
+	uint64_t nIndex = 0;
+	for (int i = 0; i < nCount; i++)
+	{
+		int nDigit = nPositions[i] - countBits(nUsed & ((1u << nPositions[i]) - 1));
+		nIndex = nIndex * (nBoardSize - i) + nDigit;
+		nUsed |= 1u << nPositions[i];
+	}
+	return nIndex;
+}
+
+void unrankPlacement(uint64_t nIndex, int nCount, int nBoardSize, int nPositions[])
+{
+	int nDigits[MAX_PATTERN_TILES];
+	for (int i = nCount - 1; i >= 0; i--)
+	{
+		nDigits[i] = (int)(nIndex % (nBoardSize - i));
+		nIndex /= (nBoardSize - i);
+	}
+	uint32_t nUsed = 0;
+	for (int i = 0; i < nCount; i++)
+	{
+		//the nDigits[i]-th position not yet used
+		int p = 0;
+		for (int nFree = nDigits[i]; ; p++)
+		{
+			if (nUsed & (1u << p))
+				continue;
+			if (nFree-- == 0)
+				break;
+		}
+		nPositions[i] = p;
+		nUsed |= 1u << p;
+	}
+}
+
+template<int N>
+uint64_t getPatternTableSize(int nTiles)
+{
+	uint64_t nSize = 1;
+	for (int i = 0; i < nTiles; i++)
+		nSize *= (uint64_t)(N * N - i);
+	return nSize;
+}
+
+//Building a table takes one cost byte and N*N settled bits per placement, so the
+//limit shrinks as the board grows: 16P8 fits on the 15-puzzle but 25P7 doesn't
+template<int N>
+uint64_t getMaxPatternTableSize()
+{
+	return MAX_PATTERN_BUILD_BYTES * 8 / (8 + N * N);
+}
+
+template<int N>
+int getMaxPatternTiles()
+{
+	int nTiles = 0;
+	while (nTiles < MAX_PATTERN_TILES && nTiles < N * N - 1 && getPatternTableSize<N>(nTiles + 1) <= getMaxPatternTableSize<N>())
+		nTiles++;
+	return nTiles;
+}
+
+template<int N>
+string getPatternDatabaseName(const BoardState<N> &goal, const vector<int> &vTiles)
+{
+	char chHash[17];
+	sprintf(chHash, "%016llx", (unsigned long long)getBoardHash(goal));
+	string strName = "pattern_" + to_string(N) + "x" + to_string(N) + "_";
+	for (unsigned int i = 0; i < vTiles.size(); i++)
+		strName += (i > 0 ? "-" : "") + to_string(vTiles[i]);
+	return strName + "_" + chHash + ".pdb";
+}
+
+//0-1 breadth first search outward from the goal placement over (placement, blank
+//position) pairs. Sliding a group tile costs 1 and any other tile costs 0, so each
+//cost layer is closed over its free moves (a stack of same-cost states) before the
+//next layer starts. A placement's cost is the layer in which it is first settled.
+template<int N>
+bool buildPatternDatabase(const BoardState<N> &goal, const vector<int> &vTiles, string path)
+{
+	const int nSize = N * N;
+	int nCount = (int)vTiles.size();
+	if (nCount < 1 || nCount > getMaxPatternTiles<N>())
+		return false;
+
+	uint64_t nPlacements = getPatternTableSize<N>(nCount);
+	vector<unsigned char> vCosts(nPlacements, PDB_UNREACHED);
+	vector<uint64_t> vSettled((nPlacements * nSize + 63) / 64, 0); //one bit per (placement, blank) pair
+
+	//Goal placement and blank
+	int nPositions[MAX_PATTERN_TILES];
+	PatternHeader header;
+	memset(&header, 0, sizeof(header));
+	for (int p = 0; p < nSize; p++)
+	{
+		for (int i = 0; i < nCount; i++)
+		{
+			if (getBoardTile(goal, p) == vTiles[i])
+				nPositions[i] = p;
+		}
+	}
+	for (int i = 0; i < nCount; i++)
+	{
+		header.m_nTiles[i] = (uint8_t)vTiles[i];
+		header.m_nGoalPositions[i] = (uint8_t)nPositions[i];
+	}
+
+	vector<uint64_t> vLayer(1, rankPlacement(nPositions, nCount, nSize) * nSize + goal.m_nBlank);
+	vector<uint64_t> vNext;
+	for (int nCost = 0; !vLayer.empty(); nCost++)
+	{
+		vNext.clear();
+		while (!vLayer.empty())
+		{
+			uint64_t nPair = vLayer.back();
+			vLayer.pop_back();
+			if (vSettled[nPair >> 6] & (1ULL << (nPair & 63)))
+				continue;
+			vSettled[nPair >> 6] |= 1ULL << (nPair & 63);
+
+			uint64_t nPlacement = nPair / nSize;
+			int nBlank = (int)(nPair % nSize);
+			if (vCosts[nPlacement] == PDB_UNREACHED)
+				vCosts[nPlacement] = (unsigned char)nCost;
+
+			unrankPlacement(nPlacement, nCount, nSize, nPositions);
+			const BoardMoves &moves = BoardConstants<N>::s_Tables.m_Moves[nBlank];
+			for (int m = 0; m < moves.m_nCount; m++)
+			{
+				int nTarget = BoardConstants<N>::s_Tables.m_nMoveTarget[nBlank][moves.m_nMoves[m]];
+
+				//Is a group tile the one that slides into the blank?
+				int nMoved = -1;
+				for (int i = 0; i < nCount; i++)
+				{
+					if (nPositions[i] == nTarget)
+						nMoved = i;
+				}
+
+				uint64_t nChild;
+				if (nMoved < 0)
+					nChild = nPlacement * nSize + nTarget; //free move, same layer
+				else
+				{
+					nPositions[nMoved] = nBlank;
+					nChild = rankPlacement(nPositions, nCount, nSize) * nSize + nTarget;
+					nPositions[nMoved] = nTarget;
+				}
+				if (vSettled[nChild >> 6] & (1ULL << (nChild & 63)))
+					continue;
+				if (nMoved < 0)
+					vLayer.push_back(nChild);
+				else
+					vNext.push_back(nChild);
+			}
+		}
+		vLayer.swap(vNext);
+	}
+
+	memcpy(header.m_chMagic, PDB_MAGIC, 4);
+	header.m_nVersion = PDB_VERSION;
+	header.m_nSize = N;
+	header.m_nTileCount = (uint32_t)nCount;
+
+	string strTemp = getTempFilePath(path);
+	ofstream file(strTemp.c_str(), ios::binary | ios::trunc);
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)&vCosts[0], vCosts.size());
+	file.close();
+	if (!file.good() || !replaceFile(strTemp, path))
+	{
+		deleteFile(strTemp);
+		return false;
+	}
+	return true;
+}
+
+//Constructor
+template<int N>
+PatternDatabase<N>::PatternDatabase() : m_pCosts(nullptr), m_nCount(0)
+{
+	for (int t = 0; t < N * N; t++)
+		m_nSlot[t] = -1;
+}
+
+//Maps the group's table from directory (which, if given, must end in a path separator).
+//The file is generated on first use, and replaced if it is invalid. Returns false if it can't be built.
+template<int N>
+bool PatternDatabase<N>::open(const BoardState<N> &goal, const vector<int> &vTiles, string directory)
+{
+	m_pCosts = nullptr;
+	m_File.close();
+	if (vTiles.empty() || (int)vTiles.size() > getMaxPatternTiles<N>())
+		return false;
+	string strPath = directory + getPatternDatabaseName(goal, vTiles);
+	if (!mapFile(strPath, goal, vTiles))
+	{
+		deleteFile(strPath);
+		if (!buildPatternDatabase(goal, vTiles, strPath) || !mapFile(strPath, goal, vTiles))
+			return false;
+	}
+
+	m_nCount = (int)vTiles.size();
+	for (int t = 0; t < N * N; t++)
+		m_nSlot[t] = -1;
+	for (int i = 0; i < m_nCount; i++)
+		m_nSlot[vTiles[i]] = i;
+	m_pCosts = m_File.getData() + sizeof(PatternHeader);
+	return true;
+}
+
+//Validates the header so a stale or truncated file is never trusted
+template<int N>
+bool PatternDatabase<N>::mapFile(string path, const BoardState<N> &goal, const vector<int> &vTiles)
+{
+	if (!m_File.open(path))
+		return false;
+	const PatternHeader* pHeader = (const PatternHeader*)m_File.getData();
+	bool bValid = m_File.getSize() == sizeof(PatternHeader) + getPatternTableSize<N>((int)vTiles.size()) && memcmp(pHeader->m_chMagic, PDB_MAGIC, 4) == 0
+		&& pHeader->m_nVersion == PDB_VERSION && pHeader->m_nSize == N && pHeader->m_nTileCount == vTiles.size();
+	for (unsigned int i = 0; bValid && i < vTiles.size(); i++)
+		bValid = pHeader->m_nTiles[i] == vTiles[i] && getBoardTile(goal, pHeader->m_nGoalPositions[i]) == vTiles[i];
+	if (!bValid)
+		m_File.close();
+	return bValid;
+}
+
+template<int N>
+bool PatternDatabase<N>::isOpen()
+{
+	return m_pCosts != nullptr;
+}
+
+template<int N>
+uint64_t PatternDatabase<N>::getIndex(const BoardState<N> &state)
+{
+	int nPositions[MAX_PATTERN_TILES];
+	for (int p = 0; p < N * N; p++)
+	{
+		int nSlot = m_nSlot[getBoardTile(state, p)];
+		if (nSlot >= 0)
+			nPositions[nSlot] = p;
+	}
+	return rankPlacement(nPositions, m_nCount, N * N);
+}
+
+template<int N>
+int PatternDatabase<N>::getCost(const BoardState<N> &state)
+{
+	return m_pCosts[getIndex(state)];
+}
+
+//Constructor. No tables exist until build is called
+template<int N>
+AdditivePatternHeuristic<N>::AdditivePatternHeuristic() : m_nGroups(0)
+{
+	m_Goal = getDefaultGoal<N>();
+	for (int t = 0; t < N * N; t++)
+		m_nGroupOf[t] = -1;
+}
+
+//Every non-blank tile must be in exactly one group, or the sum would not be admissible
+//(a tile in two groups) or would ignore a tile (a tile in none). Groups too big for
+//getMaxPatternTiles are rejected here, before any table is opened or generated.
+template<int N>
+bool AdditivePatternHeuristic<N>::build(const BoardState<N> &goal, const vector< vector<int> > &vGroups, string directory)
+{
+	m_Goal = goal;
+	m_nGroups = 0;
+	for (int t = 0; t < N * N; t++)
+		m_nGroupOf[t] = -1;
+	if (vGroups.empty() || vGroups.size() > MAX_PATTERN_GROUPS)
+		return false;
+
+	int nCovered = 0;
+	for (unsigned int g = 0; g < vGroups.size(); g++)
+	{
+		if ((int)vGroups[g].size() > getMaxPatternTiles<N>())
+			return false;
+		for (unsigned int i = 0; i < vGroups[g].size(); i++)
+		{
+			int nTile = vGroups[g][i];
+			if (nTile < 1 || nTile >= N * N || m_nGroupOf[nTile] >= 0)
+				return false;
+			m_nGroupOf[nTile] = g;
+			nCovered++;
+		}
+	}
+	if (nCovered != N * N - 1)
+		return false;
+
+	for (unsigned int g = 0; g < vGroups.size(); g++)
+	{
+		if (!m_Databases[g].open(goal, vGroups[g], directory))
+			return false;
+	}
+	m_nGroups = (int)vGroups.size();
+	return true;
+}
+
+template<int N>
+BoardState<N> AdditivePatternHeuristic<N>::getGoal()
+{
+	return m_Goal;
+}
+
+template<int N>
+int AdditivePatternHeuristic<N>::evaluate(const BoardState<N> &state)
+{
+	int h = 0;
+	for (int g = 0; g < m_nGroups; g++)
+		h += m_Databases[g].getCost(state);
+	return h;
+}
+
+//The tile that moved now sits where the parent's blank was, and only its group's cost can change
+template<int N>
+int AdditivePatternHeuristic<N>::getChildValue(const BoardState<N> &parent, int h, const BoardState<N> &child)
+{
+	PatternDatabase<N> &db = m_Databases[m_nGroupOf[getBoardTile(child, parent.m_nBlank)]];
+	return h - db.getCost(parent) + db.getCost(child);
+}
+
+//Standard partitions for the default goal (see getDefaultGoal): 6-6-3 for the 15-puzzle
+//and 6-6-6-6 for the 24-puzzle, each group a compact block of the board
+template<int N>
+bool getDefaultPatternGroups(vector< vector<int> > &vGroups)
+{
+	vGroups.clear();
+	if (N == 4)
+		return parsePatternGroups("1,5,6,9,10,13/7,8,11,12,14,15/2,3,4", vGroups);
+	if (N == 5)
+		return parsePatternGroups("1,2,6,7,11,12/3,4,5,8,9,10/13,14,15,18,19,20/16,17,21,22,23,24", vGroups);
+	return false;
+}
+
+bool parsePatternGroups(string input, vector< vector<int> > &vGroups)
+{
+	vGroups.clear();
+	vGroups.push_back(vector<int>());
+	int nTile = -1;
+	for (unsigned int i = 0; i <= input.size(); i++)
+	{
+		char ch = (i < input.size()) ? input[i] : '\0';
+		if (ch >= '0' && ch <= '9')
+		{
+			nTile = (nTile < 0 ? 0 : nTile * 10) + (ch - '0');
+			continue;
+		}
+		if (ch != ',' && ch != '/' && ch != '\0')
+			return false;
+		if (nTile < 0)
+			return false; //empty tile or group
+		vGroups.back().push_back(nTile);
+		nTile = -1;
+		if (ch == '/')
+			vGroups.push_back(vector<int>());
+	}
+	return true;
+}
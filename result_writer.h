@@ -0,0 +1,220 @@
+/////////////////////////////////////////////////////////////
+// Result writers for eight_tile_solver.
+//
+// Formats one record per puzzle into a caller's string buffer, which the
+// caller writes out in large chunks, so no record costs a system call or a
+// console write. The format is picked once per run:
+//   text    <start> <number of moves> <moves>, <start> unsolvable, <line> invalid
+//   json    one object per line: start, status, depth, moves and the search's
+//           statistics (see search_stats.h)
+//   binary  fixed-width RESULT_RECORD_BYTES records, for tools that seek to
+//           record i or map the file (layout below)
+// Moves are written as L/R/U/D, the direction the tile slides, or 2 bits
+// each in binary, as MoveString packs them (see move_string.h).
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include "move_string.h"
+#include "search_stats.h"
+
+using namespace std;
+
+#define MOVE_CHARS "LRUD"				// Letter for each move. [0] = left, [1] = right, [2] = up, [3] = down
+
+//Binary record, all integers little endian:
+//  [0]       status (ResultStatus)
+//  [1]       board width N
+//  [2..3]    number of moves
+//  [4..7]    0
+//  [8..15]   nodes expanded
+//  [16..40]  start tiles in reading order, N*N of them, the rest 0
+//  [41..47]  0
+//  [48..127] moves, 4 per byte starting at the low bits
+#define RESULT_RECORD_BYTES 128
+#define RESULT_TILES_OFFSET 16
+#define RESULT_MOVES_OFFSET 48
+#define RESULT_MAX_MOVES ((RESULT_RECORD_BYTES - RESULT_MOVES_OFFSET) * 4)	// 320
+
+enum ResultFormat
+{
+	FORMAT_TEXT,
+	FORMAT_JSON,
+	FORMAT_BINARY
+};
+
+enum ResultStatus
+{
+	RESULT_SOLVED,
+	RESULT_UNSOLVABLE,
+	RESULT_INVALID,
+	RESULT_TOO_LONG		// Binary only: solved, but with more than RESULT_MAX_MOVES moves, which are left out
+};
+
+bool getResultFormat(string name, ResultFormat &format); //Accepts text, json or binary
+void appendMoveString(string &output, const MoveString &path); //Appends moves as L/R/U/D letters
+
+class ResultWriter
+{
+public:
+	ResultWriter(ResultFormat format = FORMAT_TEXT);
+	ResultFormat getFormat();
+	void appendSolved(string &output, const string &strStart, const int* pTiles, int nWidth, const MoveString &path, const SearchStats &stats); //pTiles = start in reading order
+	void appendUnsolvable(string &output, const string &strStart, const int* pTiles, int nWidth);
+	void appendInvalid(string &output, const string &strLine, int nWidth);
+
+protected:
+	void appendRecord(string &output, ResultStatus status, const int* pTiles, int nWidth, const MoveString* pPath, uint64_t nExpanded);
+	void appendJsonString(string &output, const string &str);	//Quoted, with " \ and control characters escaped
+
+	ResultFormat m_Format;
+};
+
+bool getResultFormat(string name, ResultFormat &format)
+{
+	if (name == "text")
+		format = FORMAT_TEXT;
+	else if (name == "json")
+		format = FORMAT_JSON;
+	else if (name == "binary")
+		format = FORMAT_BINARY;
+	else
+		return false;
+	return true;
+}
+
+//Appends moves as L/R/U/D letters
+void appendMoveString(string &output, const MoveString &path)
+{
+	for (unsigned int i = 0; i < path.size(); i++)
+		output += MOVE_CHARS[path[i]];
+}
+
+ResultWriter::ResultWriter(ResultFormat format) : m_Format(format)
+{
+}
+
+ResultFormat ResultWriter::getFormat()
+{
+	return m_Format;
+}
+
+void ResultWriter::appendSolved(string &output, const string &strStart, const int* pTiles, int nWidth, const MoveString &path, const SearchStats &stats)
+{
+	switch (m_Format)
+	{
+	case FORMAT_TEXT:
+		output += strStart;
+		output += ' ';
+		output += to_string(path.size());
+		output += ' ';
+		appendMoveString(output, path);
+		output += '\n';
+		break;
+	case FORMAT_JSON:
+		output += "{\"start\":";
+		appendJsonString(output, strStart);
+		output += ",\"status\":\"solved\",\"depth\":";
+		output += to_string(path.size());
+		output += ",\"moves\":\"";
+		appendMoveString(output, path);
+		output += "\",\"stats\":";
+		output += getSearchStatsJson(stats);
+		output += "}\n";
+		break;
+	case FORMAT_BINARY:
+		appendRecord(output, path.size() > RESULT_MAX_MOVES ? RESULT_TOO_LONG : RESULT_SOLVED, pTiles, nWidth, &path, stats.m_nExpanded);
+		break;
+	}
+}
+
+void ResultWriter::appendUnsolvable(string &output, const string &strStart, const int* pTiles, int nWidth)
+{
+	switch (m_Format)
+	{
+	case FORMAT_TEXT:
+		output += strStart;
+		output += " unsolvable\n";
+		break;
+	case FORMAT_JSON:
+		output += "{\"start\":";
+		appendJsonString(output, strStart);
+		output += ",\"status\":\"unsolvable\"}\n";
+		break;
+	case FORMAT_BINARY:
+		appendRecord(output, RESULT_UNSOLVABLE, pTiles, nWidth, nullptr, 0);
+		break;
+	}
+}
+
+//The line couldn't be parsed, so it is written back as read and binary records hold no tiles
+void ResultWriter::appendInvalid(string &output, const string &strLine, int nWidth)
+{
+	switch (m_Format)
+	{
+	case FORMAT_TEXT:
+		output += strLine;
+		output += " invalid\n";
+		break;
+	case FORMAT_JSON:
+		output += "{\"start\":";
+		appendJsonString(output, strLine);
+		output += ",\"status\":\"invalid\"}\n";
+		break;
+	case FORMAT_BINARY:
+		appendRecord(output, RESULT_INVALID, nullptr, nWidth, nullptr, 0);
+		break;
+	}
+}
+
+void ResultWriter::appendRecord(string &output, ResultStatus status, const int* pTiles, int nWidth, const MoveString* pPath, uint64_t nExpanded)
+{
+	unsigned char nRecord[RESULT_RECORD_BYTES] = {};
+	size_t nMoves = (pPath != nullptr) ? pPath->size() : 0;
+	size_t nCount = (nMoves > 0xFFFF) ? 0xFFFF : nMoves;
+	nRecord[0] = (unsigned char)status;
+	nRecord[1] = (unsigned char)nWidth;
+	nRecord[2] = (unsigned char)(nCount & 0xFF);
+	nRecord[3] = (unsigned char)(nCount >> 8);
+	for (int i = 0; i < 8; i++)
+		nRecord[8 + i] = (unsigned char)(nExpanded >> (8 * i));
+	if (pTiles != nullptr)
+	{
+		for (int p = 0; p < nWidth * nWidth; p++)
+			nRecord[RESULT_TILES_OFFSET + p] = (unsigned char)pTiles[p];
+	}
+	if (status == RESULT_SOLVED)
+	{
+		for (size_t i = 0; i < nMoves; i++)
+			nRecord[RESULT_MOVES_OFFSET + i / 4] |= (unsigned char)((*pPath)[i] << (2 * (i % 4)));
+	}
+	output.append((const char*)nRecord, RESULT_RECORD_BYTES);
+}
+
+void ResultWriter::appendJsonString(string &output, const string &str)
+{
+	static const char* chHex = "0123456789abcdef";
+	output += '"';
+	for (unsigned int i = 0; i < str.size(); i++)
+	{
+		unsigned char ch = (unsigned char)str[i];
+		if (ch == '"' || ch == '\\')
+		{
+			output += '\\';
+			output += (char)ch;
+		}
+		else if (ch < 0x20)
+		{
+			output += "\\u00";
+			output += chHex[ch >> 4];
+			output += chHex[ch & 15];
+		}
+		else
+			output += (char)ch;
+	}
+	output += '"';
+}
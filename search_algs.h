@@ -10,294 +10,216 @@
 #include <conio.h>
 #include <ctime>
 #include <Windows.h>
-#include <queue>
 #include <vector>
-#include <stack>
-#include "node.h"
 #include "board.h"
+#include "packed_state.h"
+#include "solvers.h"
+#include "result_writer.h"
 
 
 using namespace std;
 
+bool g_bShowBoards = true; //Draw every board of a solution in color. If false, solutions are printed as one line of moves
+
 bool doBFSSearch(int rootboard[3][3], int goalboard[3][3], int boardsize);
 bool doOtherSearch(int rootboard[3][3], int goalboard[3][3], int boardsize, string type);
-bool isStateInQueue(Node *n, queue<Node*> q); // util function
-bool isStateInPQueue(Node *n, priority_queue<Node*> q); // util function
-void doSolutionPrint(Node *node, int goalboard[3][3]); //prints solution path and delete's the nodes in memory
-
-													  
-//Comparator function for priority queue
-struct PtrLess
-{
-	bool operator()(Node* left, Node* right)
-	{
-		return left->getTotalCost() > right->getTotalCost();
-	}
-};
-
-//Attempts to solve puzzle with BFS.
-//The BFS uses a FIFO queue and does not assign any cost to the nodes.
-//  This is the only difference between doBFSSearch() and doOtherSearch()
+bool doDatabaseSearch(int rootboard[3][3], int goalboard[3][3]);
+bool doIDAStarSearch(int rootboard[3][3], int goalboard[3][3], string heuristic);
+bool doBidirectionalSearch(int rootboard[3][3], int goalboard[3][3], string type);
+void doVisitedStatsPrint(VisitedSet &visited); //prints size and probe statistics of the visited set
+void doSolutionPrint(PackedState start, MoveString &path, int goalboard[3][3]); //prints solution path by replaying moves from start, or as moves (see g_bShowBoards)
+void doPoolStatsPrint(NodePool &pool); //prints memory used by the node arena
+void doSearchStatsPrint(SearchStats &stats); //prints the counts a search engine collected
+
+//Attempts to solve puzzle with BFS (see solveBFS in solvers.h) and prints the result.
 bool doBFSSearch(int rootboard[3][3], int goalboard[3][3], int boardsize)
 {
-	int nExpanded = 0;
-	unsigned int nMaxInSearchSpace = 0;
 	cout << "\nSolving...\n\n";
 
-
-	//Create root node, open list, and closed list
-	int nTemp[9];
-	getLinearFromMatrix(rootboard, 3, nTemp);
-	Node* node = new Node(nTemp);
-	queue<Node*> qOpenList;
-	queue<Node*> qClosedList;
-
 	//Check if goal state already
-	if (isBoardSolved(rootboard, goalboard, 3))
+	PackedState start = packMatrix(rootboard);
+	if (start == packMatrix(goalboard))
 	{
 		cout << "\nStart state was Goal state.\n\n";
 		printGameBoards(rootboard, goalboard, 3);
 		return true;
 	}
 
-	//Root state is not goal state, so continue with Breadth First Search by
-	//  adding the current state to the open list and then doing our BFS.
-	qOpenList.push(node);
-
-	while (true)
-	{
-		if (qOpenList.empty())
-			return false; //if the open list is empty, we failed at solving
-		node = qOpenList.front();
-		qOpenList.pop();
-		qClosedList.push(node);
-
-		//determine possible moves
-		vector<int> vMoves; //holds possible moves for this state. [0] = left, [1] = right, [2] = up, [3] = down. 
-		int board[3][3];		//container for current state
-		node->getMatrixState(board); //board is now the 3d matrix of current state
-
-		if (isMoveLegal(board, 0, 3)) //try left
-			vMoves.push_back(0);
-		if (isMoveLegal(board, 1, 3)) //try right
-			vMoves.push_back(1);
-		if (isMoveLegal(board, 2, 3)) //try up
-			vMoves.push_back(2);
-		if (isMoveLegal(board, 3, 3)) //try down
-			vMoves.push_back(3);
-
-		for (unsigned int i = 0; i < vMoves.size(); i++) //for each action in Actions(node.state) do:
-		{
-			//Creates new child node with the state of having made the current move 
-			//(When the nodes "child" constructor is called here, the move is performed)
-			int nTemp[9];
-			getLinearFromMatrix(board, 3, nTemp);
-			Node* child = new Node(nTemp, vMoves[i], node);
-			nExpanded++;
-
-			//look for state in open and closed lists. 
-			//  If it exists in either we don't do anything with it. If it does we check for sol and add to queue
-			if (!isStateInQueue(child, qOpenList) && !isStateInQueue(child, qClosedList))
-			{
-				int nTemp2[3][3];
-				child->getMatrixState(nTemp2);
-				if (isBoardSolved(nTemp2, goalboard, 3))
-				{
-					//Solution found. Output metrics
-					doSolutionPrint(child, goalboard);
-					cout << "\nSolution found at depth " << child->getDepth();
-					cout << " after expanding " << nExpanded << " nodes.\nA maximum of " << nMaxInSearchSpace << " nodes existed in the search space.\n\n";
-					return true;
-				}
-				else
-				{
-					qOpenList.push(child);
-					if (qOpenList.size() > nMaxInSearchSpace)
-						nMaxInSearchSpace = qOpenList.size();
-				}
-			}
-			else
-				delete child; //delete the node since we're not going to use it
-		}
-	}
+	SearchContext ctx;
+	SearchResult result;
+	if (!solveBFS(start, packMatrix(goalboard), ctx, result))
+		return false;
+
+	//Solution found. Output metrics
+	doSolutionPrint(start, result.m_Path, goalboard);
+	cout << "\nSolution found at depth " << result.m_Path.size() + 1;
+	cout << " after expanding " << result.m_Stats.m_nExpanded << " nodes.\n";
+	doSearchStatsPrint(result.m_Stats);
+	cout << "Visited bitmap marked " << ctx.m_Bitmap.getCount() << " of " << NUM_STATE_RANKS << " states.\n";
+	doPoolStatsPrint(ctx.m_Pool);
+	return true;
 }
 
-//Attempts to solve puzzle with the given algorithm type 
+//Attempts to solve puzzle with the given algorithm type (see solveBestFirst in solvers.h)
 //type options are:
 // Manhattan 
 // A* TOOP (Depth + Tiles Out Of Place heuristic)
 // A* Manhattan (Depth + Manhattan Distance as heuristic)
+// A* Linear Conflict (Depth + Manhattan Distance + Linear Conflicts as heuristic)
+// A* Walking Distance (Depth + Walking Distance as heuristic)
+//  Any heuristic name without the "A* " prefix does a greedy best-first search
 bool doOtherSearch(int rootboard[3][3], int goalboard[3][3], int boardsize, string type)
 {
-	int nExpanded = 0;
-	unsigned int nMaxInSearchSpace = 0;
+	//"A* <heuristic>" is A*, a bare heuristic name is greedy best-first
+	bool bAStar = (type.compare(0, 3, "A* ") == 0);
+	HeuristicType heuristicType;
+	if (!getHeuristicType(bAStar ? type.substr(3) : type, heuristicType))
+		return false;
 
 	cout << "\nSolving...\n\n";
 
-
-	//Create root node, open list, and closed list
-	int nTemp[9];
-	getLinearFromMatrix(rootboard, 3, nTemp);
-	Node* node = new Node(nTemp);
-	priority_queue<Node *, std::vector< Node * >, PtrLess> qOpenList;
-	priority_queue<Node *, std::vector< Node * >, PtrLess> qClosedList;
-
 	//Check if goal state already
-	if (isBoardSolved(rootboard, goalboard, 3))
+	PackedState start = packMatrix(rootboard);
+	if (start == packMatrix(goalboard))
 	{
 		cout << "\nStart state was Goal state.\n\n";
 		printGameBoards(rootboard, goalboard, 3);
 		return true;
 	}
 
-	//Root state is not goal state, so continue with Breadth First Search by
-	//  adding the current state to the open list and then doing our BFS.
-	qOpenList.push(node);
-
-	while (true)
-	{
-		if (qOpenList.empty())
-			return false; //if the open list is empty, we failed at solving
-		node = qOpenList.top();
-		qOpenList.pop();
-		qClosedList.push(node);
-
-		//determine possible moves
-		vector<int> vMoves; //holds possible moves for this state. [0] = left, [1] = right, [2] = up, [3] = down. 
-		int board[3][3];		//container for current state
-		node->getMatrixState(board); //board is now the 3d matrix of current state	
+	SearchContext ctx;
+	SearchResult result;
+	if (!solveBestFirst(start, packMatrix(goalboard), heuristicType, bAStar, ctx, result))
+		return false;
+
+	//Solution found. Output metrics
+	cout << "\nSolution found at depth " << result.m_Path.size() + 1;
+	cout << " after expanding " << result.m_Stats.m_nExpanded << " nodes.\n";
+	doSearchStatsPrint(result.m_Stats);
+	doPoolStatsPrint(ctx.m_Pool);
+	doVisitedStatsPrint(ctx.m_Visited);
+	doSolutionPrint(start, result.m_Path, goalboard);
+	return true;
+}
 
-		if (isMoveLegal(board, 0, 3)) //try left
-			vMoves.push_back(0);
-		if (isMoveLegal(board, 1, 3)) //try right
-			vMoves.push_back(1);
-		if (isMoveLegal(board, 2, 3)) //try up
-			vMoves.push_back(2);
-		if (isMoveLegal(board, 3, 3)) //try down
-			vMoves.push_back(3);
+//Solves the puzzle with no search by walking the precomputed distance database
+//for the goal's canonical goal (see distance_db.h and goal_canonical.h), so the
+//same few databases serve any goal entered. The database is generated on first use.
+bool doDatabaseSearch(int rootboard[3][3], int goalboard[3][3])
+{
+	cout << "\nSolving...\n\n";
 
-		for (unsigned int i = 0; i < vMoves.size(); i++) //for each action in Actions(node.state) do:
-		{
-			//Creates new child node with the state of having made the current move 
-			//(When the nodes "child" constructor is called here, the move is performed)
-			int nTemp[9];
-			getLinearFromMatrix(board, 3, nTemp);
-			Node* child = new Node(nTemp, vMoves[i], node);
-			nExpanded++;
+	GoalCanonicalizer<3> canon;
+	buildGoalCanonicalizer(packMatrix(goalboard), canon);
+	DistanceDatabase db;
+	PackedState goalState = getCanonicalGoal(canon);
+	if (!db.open(goalState))
+	{
+		cout << "Could not open or generate " << getDistanceDatabaseName(goalState) << ".\n";
+		return false;
+	}
 
-			//look for state in open and closed lists. 
-			//  If it exists in either we don't do anything with it. else if not sol we add to queue
-			/*cout << isStateInPQueue(child, qOpenList) << " : ";
-			cout << isStateInPQueue(child, qClosedList) << endl;*/
-			/*if (!isStateInPQueue(child, qOpenList) && !isStateInPQueue(child, qClosedList))
-			{*/
-				int childboard[3][3];
-				child->getMatrixState(childboard);
-				if (isBoardSolved(childboard, goalboard, 3))
-				{
-					//Solution found. Output metrics
-					cout << "\nSolution found at depth " << child->getDepth();
-					cout << " after expanding " << nExpanded << " nodes.\nA maximum of " << nMaxInSearchSpace << " nodes existed in the search space.\n\n";
-					doSolutionPrint(child, goalboard);
-					return true;
-				}
-				else
-				{
-					//type options are
-					// Manhattan 
-					// A* TOOP = (Depth + Tiles Out Of Place) as heuristic
-					// A* Manhattan = (Depth + Manhattan Distance) as heuristic
-					if (type == "Manhattan")
-					{
-						child->setTotalCost(getManhattanHeuristic(childboard, goalboard, 3));
-					}
-					else if (type == "A* TOOP")
-					{
-						child->setTotalCost(child->getDepth() + getTilesOutOfOrderHeuristic(childboard, goalboard, 3));
-					}
-					else if (type == "A* Manhattan")
-					{
-						child->setTotalCost(child->getDepth() + getManhattanHeuristic(childboard, goalboard, 3));
-					}
-					else
-						return false;
+	MoveString path;
+	if (!db.solve(canonicalizeState(canon, packMatrix(rootboard)), path))
+		return false;
+	restoreMoves(canon, path);
 
+	cout << "\nSolution found at depth " << path.size() + 1 << " by table lookup (no nodes expanded).\n\n";
+	doSolutionPrint(packMatrix(rootboard), path, goalboard);
+	return true;
+}
 
-					if (qOpenList.size() >= 250) //break infinite loop if one appears to have started.
-						return false;
+//Attempts to solve puzzle with IDA* and the named heuristic (see ida_star.h and heuristics.h).
+//Keeps no open or closed list, so memory use grows only with the solution depth.
+bool doIDAStarSearch(int rootboard[3][3], int goalboard[3][3], string heuristic)
+{
+	HeuristicType heuristicType;
+	if (!getHeuristicType(heuristic, heuristicType))
+		return false;
+	cout << "\nSolving...\n\n";
 
-					qOpenList.push(child);
-					if (qOpenList.size() > nMaxInSearchSpace)
-						nMaxInSearchSpace = qOpenList.size();
+	MoveString path;
+	SearchStats stats;
+	if (!solveIDAStar(packMatrix(rootboard), packMatrix(goalboard), path, stats, heuristicType))
+		return false;
 
-				}
-			//}
-			//else
-			//	delete child; //delete the node since we're not going to use it
-		}
-	}
+	cout << "\nSolution found at depth " << path.size() + 1 << " after expanding " << stats.m_nExpanded << " nodes.\n";
+	doSearchStatsPrint(stats);
+	cout << "At most " << path.size() << " moves were held in memory.\n\n";
+	doSolutionPrint(packMatrix(rootboard), path, goalboard);
+	return true;
 }
 
-//utility functions
-bool isStateInQueue(Node *n, queue<Node*> q)
+//Attempts to solve puzzle by searching from both the start and the goal until the
+//searches meet (see bidirectional.h). type is "BFS" or "A* <heuristic>" (ex: A* Manhattan)
+bool doBidirectionalSearch(int rootboard[3][3], int goalboard[3][3], string type)
 {
-	for (unsigned int j = 0; j < q.size(); j++)
+	SolverAlgorithm algorithm;
+	algorithm.m_Engine = ENGINE_BIDIRECTIONAL_BFS;
+	algorithm.m_Heuristic = H_MANHATTAN;
+	if (type != "BFS")
 	{
-		Node *temp = q.front();
-		q.pop();
-		int nTemp1[9];
-		n->getLinearState(nTemp1);
-		int nTemp2[9];
-		temp->getLinearState(nTemp2);
-
-		if (nTemp2[0] == nTemp1[0] && nTemp2[1] == nTemp1[1] && nTemp2[2] == nTemp1[2] && nTemp2[3] == nTemp1[3]
-			&& nTemp2[4] == nTemp1[4] && nTemp2[5] == nTemp1[5] && nTemp2[5] == nTemp1[5] && nTemp2[6] == nTemp1[6]
-			&& nTemp2[7] == nTemp1[7] && nTemp2[8] == nTemp1[8] && nTemp2[9] == nTemp1[9])
-			return true;
+		if (type.compare(0, 3, "A* ") != 0 || !getHeuristicType(type.substr(3), algorithm.m_Heuristic))
+			return false;
+		algorithm.m_Engine = ENGINE_BIDIRECTIONAL_ASTAR;
 	}
-	return false;
+	cout << "\nSolving...\n\n";
 
+	SearchContext ctx;
+	SearchResult result;
+	PackedState start = packMatrix(rootboard);
+	if (!solvePuzzle(start, packMatrix(goalboard), algorithm, ctx, result))
+		return false;
+
+	cout << "\nSolution found at depth " << result.m_Path.size() + 1 << " after expanding " << result.m_Stats.m_nExpanded << " nodes.\n";
+	doSearchStatsPrint(result.m_Stats);
+	cout << "Forward and backward visited sets held " << ctx.m_Visited.getSize() << " and " << ctx.m_BackwardVisited.getSize() << " states.\n";
+	doPoolStatsPrint(ctx.m_Pool);
+	cout << endl;
+	doSolutionPrint(start, result.m_Path, goalboard);
+	return true;
 }
 
-bool isStateInPQueue(Node *n, priority_queue<Node*> q)
+//utility functions
+void doVisitedStatsPrint(VisitedSet &visited)
 {
-	for (unsigned int j = 0; j < q.size(); j++)
-	{
-		Node *temp = q.top();
-		q.pop();
-		int nTemp1[9];
-		n->getLinearState(nTemp1);
-		int nTemp2[9];
-		temp->getLinearState(nTemp2);
+	cout << "Visited set held " << visited.getSize() << " states (load factor " << visited.getLoadFactor();
+	cout << ", average probe length " << visited.getAverageProbeLength() << ", max probe length " << visited.getMaxProbeLength() << ").\n\n";
+}
 
-		if (nTemp2[0] == nTemp1[0] && nTemp2[1] == nTemp1[1] && nTemp2[2] == nTemp1[2] && nTemp2[3] == nTemp1[3] && nTemp2[4] == nTemp1[4] && nTemp2[5] == nTemp1[5] && nTemp2[5] == nTemp1[5] && nTemp2[6] == nTemp1[6] && nTemp2[7] == nTemp1[7] && nTemp2[8] == nTemp1[8] && nTemp2[9] == nTemp1[9])
-			return true;
-	}
-	return false;
+void doPoolStatsPrint(NodePool &pool)
+{
+	cout << "Node arena reserved " << pool.getBytesReserved() << " bytes, peak use " << pool.getPeakBytesUsed();
+	cout << " bytes (" << pool.getPeakNodesInUse() << " nodes).\n";
 }
 
-void doSolutionPrint(Node *node, int goalboard[3][3])
+void doSearchStatsPrint(SearchStats &stats)
 {
-	cout << "Path from Start to Goal (Red tiles denote out-of-place tiles):\n";
-	stack<Node*> s;
+	cout << stats.m_nGenerated << " nodes were generated, " << stats.m_nDuplicates << " of them dropped as duplicates and " << stats.m_nPruned << " cut off by the bound, and ";
+	cout << stats.m_nReopened << " states were re-opened with a cheaper path.\n";
+	cout << "The heuristic was evaluated " << stats.m_nHeuristicEvaluations << " times. At most " << stats.m_nPeakOpen << " nodes were open and ";
+	cout << stats.m_nPeakClosed << " states visited.\n";
+}
 
-	//Push all path nodes onto a stack so we can print them in reverse order.
-	while (node != nullptr)
+void doSolutionPrint(PackedState start, MoveString &path, int goalboard[3][3])
+{
+	if (!g_bShowBoards)
 	{
-		s.push(node);
-		node = node->getParent();
+		string strMoves;
+		appendMoveString(strMoves, path);
+		cout << "Moves from Start to Goal (the direction each tile slides): " << strMoves << "\n";
+		return;
 	}
 
-	//Pop them all off the stack and print them
-	while (!s.empty())
+	cout << "Path from Start to Goal (Red tiles denote out-of-place tiles):\n";
+	PackedState state = start;
+	for (unsigned int i = 0; i <= path.size(); i++)
 	{
-		Node *node = s.top();
-		s.pop();
 		int nTemp[3][3];
-		node->getMatrixState(nTemp);
+		unpackMatrix(state, nTemp);
 		printGameBoards(nTemp, goalboard, 3);
 		cout << endl;
-		delete node;
+		if (i < path.size())
+			state = slidePackedTile(state, path[i]);
 	}
 }
-
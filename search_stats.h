@@ -0,0 +1,151 @@
+/////////////////////////////////////////////////////////////
+// Search statistics for eight_tile_solver.
+//
+// Every engine fills a SearchStats as it runs: nodes generated, expanded,
+// rejected as duplicates or cut off by an IDA* bound, re-opens, heuristic
+// evaluations and the peak sizes of its open and closed lists. A child is
+// counted as generated as soon as its state is made, before any duplicate
+// check, so every engine counts the same thing and rates can be compared.
+// If m_bTimed is set before the search, the time spent in each phase
+// (successor generation, heuristic, duplicate check, open list operations)
+// is also measured with std::chrono. The clock reads are skipped entirely
+// when it isn't set, so untimed searches pay only a branch per phase.
+// getSearchStatsJson exports the lot as one JSON object.
+// Does no console output. Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+enum SearchPhase
+{
+	PHASE_EXPAND,		// Finding legal moves and making the child states and nodes
+	PHASE_HEURISTIC,	// Evaluating h
+	PHASE_DUPLICATE,	// Looking states up in, and adding them to, the visited structures
+	PHASE_QUEUE,		// Open list pushes and pops
+	NUM_SEARCH_PHASES
+};
+
+struct SearchStats
+{
+	SearchStats();
+	uint64_t m_nGenerated;		// Child states made, duplicates included
+	uint64_t m_nExpanded;		// Nodes whose successors were generated
+	uint64_t m_nDuplicates;		// Children dropped because their state was already reached as cheaply
+	uint64_t m_nPruned;			// Children cut off by the cost bound (IDA* only)
+	uint64_t m_nReopened;		// States re-opened with a cheaper path (A* only)
+	uint64_t m_nHeuristicEvaluations;
+	uint64_t m_nPeakOpen;		// Largest open list, or deepest path for IDA*
+	uint64_t m_nPeakClosed;		// Most states held in the visited structures
+	bool m_bTimed;				// Measure m_dPhaseSeconds. Kept by clearSearchStats
+	double m_dPhaseSeconds[NUM_SEARCH_PHASES];
+};
+
+//Adds the time from construction to destruction to one phase of stats, if stats is timed
+class PhaseTimer
+{
+public:
+	PhaseTimer(SearchStats &stats, SearchPhase phase);
+	~PhaseTimer();
+
+protected:
+	SearchStats &m_Stats;
+	SearchPhase m_Phase;
+	chrono::steady_clock::time_point m_Start;
+};
+
+void clearSearchStats(SearchStats &stats); //Zeroes every count and timer, keeping m_bTimed
+void addSearchStats(SearchStats &total, const SearchStats &part); //Sums counts and times; peaks take the larger
+void updateSearchPeak(uint64_t &nPeak, uint64_t nSize); //Raises nPeak to nSize if larger
+string getSearchStatsJson(const SearchStats &stats); //ex: {"generated":12,"expanded":5,...}
+const char* getSearchPhaseName(SearchPhase phase);
+
+SearchStats::SearchStats() : m_bTimed(false)
+{
+	clearSearchStats(*this);
+}
+
+PhaseTimer::PhaseTimer(SearchStats &stats, SearchPhase phase) : m_Stats(stats), m_Phase(phase)
+{
+	if (m_Stats.m_bTimed)
+		m_Start = chrono::steady_clock::now();
+}
+
+PhaseTimer::~PhaseTimer()
+{
+	if (m_Stats.m_bTimed)
+		m_Stats.m_dPhaseSeconds[m_Phase] += chrono::duration<double>(chrono::steady_clock::now() - m_Start).count();
+}
+
+void clearSearchStats(SearchStats &stats)
+{
+	stats.m_nGenerated = 0;
+	stats.m_nExpanded = 0;
+	stats.m_nDuplicates = 0;
+	stats.m_nPruned = 0;
+	stats.m_nReopened = 0;
+	stats.m_nHeuristicEvaluations = 0;
+	stats.m_nPeakOpen = 0;
+	stats.m_nPeakClosed = 0;
+	for (int i = 0; i < NUM_SEARCH_PHASES; i++)
+		stats.m_dPhaseSeconds[i] = 0;
+}
+
+void addSearchStats(SearchStats &total, const SearchStats &part)
+{
+	total.m_nGenerated += part.m_nGenerated;
+	total.m_nExpanded += part.m_nExpanded;
+	total.m_nDuplicates += part.m_nDuplicates;
+	total.m_nPruned += part.m_nPruned;
+	total.m_nReopened += part.m_nReopened;
+	total.m_nHeuristicEvaluations += part.m_nHeuristicEvaluations;
+	total.m_nPeakOpen = max(total.m_nPeakOpen, part.m_nPeakOpen);
+	total.m_nPeakClosed = max(total.m_nPeakClosed, part.m_nPeakClosed);
+	for (int i = 0; i < NUM_SEARCH_PHASES; i++)
+		total.m_dPhaseSeconds[i] += part.m_dPhaseSeconds[i];
+}
+
+void updateSearchPeak(uint64_t &nPeak, uint64_t nSize)
+{
+	if (nSize > nPeak)
+		nPeak = nSize;
+}
+
+const char* getSearchPhaseName(SearchPhase phase)
+{
+	static const char* chNames[NUM_SEARCH_PHASES] = { "expand", "heuristic", "duplicate_check", "queue" };
+	return chNames[phase];
+}
+
+//Phase times (in seconds) are included only for timed stats
+string getSearchStatsJson(const SearchStats &stats)
+{
+	string strJson = "{\"generated\":" + to_string(stats.m_nGenerated);
+	strJson += ",\"expanded\":" + to_string(stats.m_nExpanded);
+	strJson += ",\"duplicates\":" + to_string(stats.m_nDuplicates);
+	strJson += ",\"pruned\":" + to_string(stats.m_nPruned);
+	strJson += ",\"reopened\":" + to_string(stats.m_nReopened);
+	strJson += ",\"heuristic_evaluations\":" + to_string(stats.m_nHeuristicEvaluations);
+	strJson += ",\"peak_open\":" + to_string(stats.m_nPeakOpen);
+	strJson += ",\"peak_closed\":" + to_string(stats.m_nPeakClosed);
+	if (stats.m_bTimed)
+	{
+		strJson += ",\"seconds\":{";
+		for (int i = 0; i < NUM_SEARCH_PHASES; i++)
+		{
+			char chTime[32];
+			snprintf(chTime, sizeof(chTime), "%.9f", stats.m_dPhaseSeconds[i]);
+			strJson += (i > 0 ? ",\"" : "\"") + string(getSearchPhaseName((SearchPhase)i)) + "\":" + chTime;
+		}
+		strJson += "}";
+	}
+	return strJson + "}";
+}
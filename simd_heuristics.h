@@ -0,0 +1,305 @@
+/////////////////////////////////////////////////////////////
+// Batch heuristic kernels for eight_tile_solver.
+//
+// Scores many packed states against one goal in a single call, for bulk
+// queries such as scoring a corpus, a database or a batch file. The nine
+// 4-bit tiles of a state are spread into the bytes of a vector register, and
+// one byte shuffle per goal table looks up every tile's goal row, column or
+// position at once, since those depend on the tile only. Comparing them with
+// constant vectors of each byte's own row, column and position gives the
+// Manhattan distance or the misplaced count of all tiles, and a sum of
+// absolute differences adds them up. SSSE3 scores one state per step and AVX2
+// two. The widest level the CPU and OS support is picked at runtime by cpuid;
+// other CPUs, or builds for other architectures, use the scalar tables of
+// heuristics.h, which every kernel matches exactly.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "packed_state.h"
+#include "heuristics.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+//MSVC compiles any intrinsic; GCC and Clang need each kernel marked with its instruction set
+#if defined(SIMD_X86) && defined(__GNUC__)
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+using namespace std;
+
+enum SimdLevel
+{
+	SIMD_SCALAR,
+	SIMD_SSSE3,
+	SIMD_AVX2
+};
+
+SimdLevel getSupportedSimdLevel(); //Widest level this CPU and OS run, detected once
+const char* getSimdLevelName(SimdLevel level);
+
+class BatchTileHeuristic
+{
+public:
+	BatchTileHeuristic();
+	bool build(PackedState goal, HeuristicType type);	//type must be H_MANHATTAN or H_MISPLACED, else returns false
+	void setSimdLevel(SimdLevel level);					//Uses at most level, for testing. Defaults to getSupportedSimdLevel()
+	SimdLevel getSimdLevel();
+	void evaluate(const PackedState* pStates, size_t nCount, int* pValues);	//pValues[i] = h of pStates[i]
+
+protected:
+	void evaluateScalar(const PackedState* pStates, size_t nCount, int* pValues);
+	void evaluateSSSE3(const PackedState* pStates, size_t nCount, int* pValues);
+	void evaluateAVX2(const PackedState* pStates, size_t nCount, int* pValues);
+
+	HeuristicType m_Type;
+	SimdLevel m_Level;
+	TileDistanceTable m_Table;		// Scalar fallback, and the reference every kernel matches
+	unsigned char m_nGoalRow[16];	// [tile] = row of its goal position, as a shuffle table
+	unsigned char m_nGoalCol[16];
+	unsigned char m_nGoalPos[16];
+};
+
+#ifdef SIMD_X86
+//CPUID leaf 1 reports SSSE3, AVX and whether the OS uses XSAVE; leaf 7 reports AVX2.
+//AVX2 also needs the OS to save the YMM registers, which XGETBV reports.
+static SimdLevel detectSimdLevel()
+{
+	unsigned int nEcx1, nEbx7;
+#ifdef _MSC_VER
+	int nRegs[4];
+	__cpuid(nRegs, 0);
+	int nMaxLeaf = nRegs[0];
+	__cpuid(nRegs, 1);
+	nEcx1 = (unsigned int)nRegs[2];
+	nEbx7 = 0;
+	if (nMaxLeaf >= 7)
+	{
+		__cpuidex(nRegs, 7, 0);
+		nEbx7 = (unsigned int)nRegs[1];
+	}
+#else
+	unsigned int nEax, nEbx, nEdx;
+	if (!__get_cpuid(1, &nEax, &nEbx, &nEcx1, &nEdx))
+		return SIMD_SCALAR;
+	nEbx7 = 0;
+	if (__get_cpuid_max(0, nullptr) >= 7)
+	{
+		unsigned int nEcx7;
+		__cpuid_count(7, 0, nEax, nEbx7, nEcx7, nEdx);
+	}
+#endif
+	if (!(nEcx1 & (1u << 9)))
+		return SIMD_SCALAR;
+
+	bool bAvx = (nEcx1 & (1u << 27)) && (nEcx1 & (1u << 28)); //OSXSAVE and AVX
+	if (bAvx)
+	{
+#ifdef _MSC_VER
+		uint64_t nXcr0 = _xgetbv(0);
+#else
+		unsigned int nLow, nHigh;
+		__asm__ volatile("xgetbv" : "=a"(nLow), "=d"(nHigh) : "c"(0));
+		uint64_t nXcr0 = ((uint64_t)nHigh << 32) | nLow;
+#endif
+		if ((nXcr0 & 6) == 6 && (nEbx7 & (1u << 5)))
+			return SIMD_AVX2;
+	}
+	return SIMD_SSSE3;
+}
+#else
+static SimdLevel detectSimdLevel()
+{
+	return SIMD_SCALAR;
+}
+#endif
+
+SimdLevel getSupportedSimdLevel()
+{
+	static const SimdLevel level = detectSimdLevel();
+	return level;
+}
+
+const char* getSimdLevelName(SimdLevel level)
+{
+	static const char* chNames[] = { "scalar", "ssse3", "avx2" };
+	return chNames[level];
+}
+
+BatchTileHeuristic::BatchTileHeuristic() : m_Type(H_MANHATTAN), m_Level(getSupportedSimdLevel())
+{
+	for (int t = 0; t < 16; t++)
+	{
+		m_nGoalRow[t] = 0;
+		m_nGoalCol[t] = 0;
+		m_nGoalPos[t] = 0;
+	}
+}
+
+bool BatchTileHeuristic::build(PackedState goal, HeuristicType type)
+{
+	if (type == H_MANHATTAN)
+		m_Table.buildManhattan(goal);
+	else if (type == H_MISPLACED)
+		m_Table.buildMisplaced(goal);
+	else
+		return false;
+	m_Type = type;
+
+	for (int p = 0; p < 9; p++)
+	{
+		int nTile = getPackedTile(goal, p);
+		m_nGoalRow[nTile] = (unsigned char)(p / 3);
+		m_nGoalCol[nTile] = (unsigned char)(p % 3);
+		m_nGoalPos[nTile] = (unsigned char)p;
+	}
+	return true;
+}
+
+void BatchTileHeuristic::setSimdLevel(SimdLevel level)
+{
+	m_Level = (level < getSupportedSimdLevel()) ? level : getSupportedSimdLevel();
+}
+
+SimdLevel BatchTileHeuristic::getSimdLevel()
+{
+	return m_Level;
+}
+
+void BatchTileHeuristic::evaluate(const PackedState* pStates, size_t nCount, int* pValues)
+{
+	switch (m_Level)
+	{
+	case SIMD_AVX2:
+		evaluateAVX2(pStates, nCount, pValues);
+		break;
+	case SIMD_SSSE3:
+		evaluateSSSE3(pStates, nCount, pValues);
+		break;
+	default:
+		evaluateScalar(pStates, nCount, pValues);
+		break;
+	}
+}
+
+void BatchTileHeuristic::evaluateScalar(const PackedState* pStates, size_t nCount, int* pValues)
+{
+	for (size_t i = 0; i < nCount; i++)
+		pValues[i] = m_Table.evaluate(pStates[i]);
+}
+
+#ifdef SIMD_X86
+//Byte p of the result holds the tile at position p; bytes 9..15 hold 0, the blank, and so cost nothing
+SIMD_TARGET("ssse3")
+static inline __m128i spreadPackedTiles(const PackedState &state)
+{
+	const __m128i nibbles = _mm_set1_epi8(0x0F);
+	__m128i x = _mm_loadl_epi64((const __m128i*)&state.m_nTiles);
+	__m128i lo = _mm_and_si128(x, nibbles);
+	__m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibbles);
+	return _mm_unpacklo_epi8(lo, hi);
+}
+
+//Per-tile costs for the tiles in each byte. The blank (0) is masked out
+SIMD_TARGET("ssse3")
+static inline __m128i getTileCostsSSSE3(__m128i tiles, bool bManhattan, __m128i rowTable, __m128i colTable, __m128i posTable)
+{
+	const __m128i positions = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 0, 0, 0, 0, 0);
+	__m128i tile = _mm_cmpgt_epi8(tiles, _mm_setzero_si128());
+	if (bManhattan)
+	{
+		const __m128i rows = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0);
+		const __m128i cols = _mm_setr_epi8(0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 0, 0, 0, 0, 0, 0);
+		__m128i dRow = _mm_abs_epi8(_mm_sub_epi8(_mm_shuffle_epi8(rowTable, tiles), rows));
+		__m128i dCol = _mm_abs_epi8(_mm_sub_epi8(_mm_shuffle_epi8(colTable, tiles), cols));
+		return _mm_and_si128(_mm_add_epi8(dRow, dCol), tile);
+	}
+	__m128i misplaced = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_shuffle_epi8(posTable, tiles), positions), tile);
+	return _mm_and_si128(misplaced, _mm_set1_epi8(1));
+}
+
+SIMD_TARGET("ssse3")
+void BatchTileHeuristic::evaluateSSSE3(const PackedState* pStates, size_t nCount, int* pValues)
+{
+	__m128i rowTable = _mm_loadu_si128((const __m128i*)m_nGoalRow);
+	__m128i colTable = _mm_loadu_si128((const __m128i*)m_nGoalCol);
+	__m128i posTable = _mm_loadu_si128((const __m128i*)m_nGoalPos);
+	bool bManhattan = (m_Type == H_MANHATTAN);
+	for (size_t i = 0; i < nCount; i++)
+	{
+		__m128i costs = getTileCostsSSSE3(spreadPackedTiles(pStates[i]), bManhattan, rowTable, colTable, posTable);
+		__m128i sums = _mm_sad_epu8(costs, _mm_setzero_si128());
+		pValues[i] = _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+	}
+}
+
+//Two states per step, one in each 128-bit lane, since byte shuffles stay within a lane
+SIMD_TARGET("avx2")
+void BatchTileHeuristic::evaluateAVX2(const PackedState* pStates, size_t nCount, int* pValues)
+{
+	__m256i rowTable = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)m_nGoalRow));
+	__m256i colTable = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)m_nGoalCol));
+	__m256i posTable = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)m_nGoalPos));
+	const __m256i positions = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 0, 0, 0, 0, 0));
+	const __m256i rows = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 0, 0, 0, 0, 0, 0, 0));
+	const __m256i cols = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 0, 0, 0, 0, 0, 0));
+	const __m256i nibbles = _mm256_set1_epi8(0x0F);
+	const __m256i zero = _mm256_setzero_si256();
+	bool bManhattan = (m_Type == H_MANHATTAN);
+
+	size_t i = 0;
+	for (; i + 2 <= nCount; i += 2)
+	{
+		__m128i x0 = _mm_loadl_epi64((const __m128i*)&pStates[i].m_nTiles);
+		__m128i x1 = _mm_loadl_epi64((const __m128i*)&pStates[i + 1].m_nTiles);
+		__m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(x0), x1, 1);
+		__m256i lo = _mm256_and_si256(x, nibbles);
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibbles);
+		__m256i tiles = _mm256_unpacklo_epi8(lo, hi);
+
+		__m256i tile = _mm256_cmpgt_epi8(tiles, zero);
+		__m256i costs;
+		if (bManhattan)
+		{
+			__m256i dRow = _mm256_abs_epi8(_mm256_sub_epi8(_mm256_shuffle_epi8(rowTable, tiles), rows));
+			__m256i dCol = _mm256_abs_epi8(_mm256_sub_epi8(_mm256_shuffle_epi8(colTable, tiles), cols));
+			costs = _mm256_and_si256(_mm256_add_epi8(dRow, dCol), tile);
+		}
+		else
+		{
+			__m256i misplaced = _mm256_andnot_si256(_mm256_cmpeq_epi8(_mm256_shuffle_epi8(posTable, tiles), positions), tile);
+			costs = _mm256_and_si256(misplaced, _mm256_set1_epi8(1));
+		}
+
+		__m256i sums = _mm256_sad_epu8(costs, zero); //one 64-bit sum per 8 bytes
+		pValues[i] = _mm256_extract_epi32(sums, 0) + _mm256_extract_epi32(sums, 2);
+		pValues[i + 1] = _mm256_extract_epi32(sums, 4) + _mm256_extract_epi32(sums, 6);
+	}
+	if (i < nCount)
+		evaluateSSSE3(pStates + i, nCount - i, pValues + i);
+}
+#else
+void BatchTileHeuristic::evaluateSSSE3(const PackedState* pStates, size_t nCount, int* pValues)
+{
+	evaluateScalar(pStates, nCount, pValues);
+}
+
+void BatchTileHeuristic::evaluateAVX2(const PackedState* pStates, size_t nCount, int* pValues)
+{
+	evaluateScalar(pStates, nCount, pValues);
+}
+#endif
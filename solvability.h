@@ -0,0 +1,128 @@
+/////////////////////////////////////////////////////////////
+// Solvability filter for eight_tile_solver.
+//
+// A start can reach a goal iff their parities match (see getStateParity in
+// state_rank.h and getBoardParity in nxn_board.h), and both are counted with
+// one XOR per tile and a single bit count on the packed state. The filter
+// keeps the goal's parity, computed once when the goal is set, so a query is
+// one parity of the start and one compare, and rejects unsolvable starts
+// before a solver, canonicalization or heuristic table is touched. filter()
+// checks a whole array in one call.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stddef.h>
+#include "packed_state.h"
+#include "state_rank.h"
+#include "nxn_board.h"
+
+using namespace std;
+
+class SolvabilityFilter
+{
+public:
+	SolvabilityFilter();
+	void setGoal(PackedState goal);			//Caches goal's parity. Does nothing if goal is already set
+	PackedState getGoal();
+	bool isSolvable(PackedState start);		//True if start can reach the goal
+	size_t filter(const PackedState* pStates, size_t nCount, bool* pSolvable);	//pSolvable[i] = isSolvable(pStates[i]). Returns the number solvable
+
+protected:
+	PackedState m_Goal;
+	int m_nGoalParity;
+};
+
+template<int N>
+class BoardSolvabilityFilter
+{
+public:
+	BoardSolvabilityFilter();
+	void setGoal(const BoardState<N> &goal);	//As SolvabilityFilter, for NxN boards
+	BoardState<N> getGoal();
+	bool isSolvable(const BoardState<N> &start);
+	size_t filter(const BoardState<N>* pStates, size_t nCount, bool* pSolvable);
+
+protected:
+	BoardState<N> m_Goal;
+	int m_nGoalParity;
+};
+
+//Starts with the standard goal, 123456780
+SolvabilityFilter::SolvabilityFilter()
+{
+	int nGoal[9] = { 1, 2, 3, 4, 5, 6, 7, 8, 0 };
+	m_Goal = packState(nGoal);
+	m_nGoalParity = getStateParity(m_Goal);
+}
+
+void SolvabilityFilter::setGoal(PackedState goal)
+{
+	if (goal == m_Goal)
+		return;
+	m_Goal = goal;
+	m_nGoalParity = getStateParity(goal);
+}
+
+PackedState SolvabilityFilter::getGoal()
+{
+	return m_Goal;
+}
+
+bool SolvabilityFilter::isSolvable(PackedState start)
+{
+	return getStateParity(start) == m_nGoalParity;
+}
+
+size_t SolvabilityFilter::filter(const PackedState* pStates, size_t nCount, bool* pSolvable)
+{
+	size_t nSolvable = 0;
+	for (size_t i = 0; i < nCount; i++)
+	{
+		pSolvable[i] = getStateParity(pStates[i]) == m_nGoalParity;
+		nSolvable += pSolvable[i];
+	}
+	return nSolvable;
+}
+
+//Starts with the standard goal, 1, 2, ..., N*N-1 with the blank last
+template<int N>
+BoardSolvabilityFilter<N>::BoardSolvabilityFilter() : m_Goal(getDefaultGoal<N>())
+{
+	m_nGoalParity = getBoardParity<N>(m_Goal);
+}
+
+template<int N>
+void BoardSolvabilityFilter<N>::setGoal(const BoardState<N> &goal)
+{
+	if (goal == m_Goal)
+		return;
+	m_Goal = goal;
+	m_nGoalParity = getBoardParity<N>(goal);
+}
+
+template<int N>
+BoardState<N> BoardSolvabilityFilter<N>::getGoal()
+{
+	return m_Goal;
+}
+
+template<int N>
+bool BoardSolvabilityFilter<N>::isSolvable(const BoardState<N> &start)
+{
+	return getBoardParity<N>(start) == m_nGoalParity;
+}
+
+template<int N>
+size_t BoardSolvabilityFilter<N>::filter(const BoardState<N>* pStates, size_t nCount, bool* pSolvable)
+{
+	size_t nSolvable = 0;
+	for (size_t i = 0; i < nCount; i++)
+	{
+		pSolvable[i] = getBoardParity<N>(pStates[i]) == m_nGoalParity;
+		nSolvable += pSolvable[i];
+	}
+	return nSolvable;
+}
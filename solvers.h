@@ -0,0 +1,410 @@
+/////////////////////////////////////////////////////////////
+// Non-interactive solver engines for eight_tile_solver.
+//
+// Every engine takes packed start and goal states, reuses the arena, visited
+// structures and database held in a SearchContext, and reports the solution
+// as a list of moves in a SearchResult. Nothing here writes to the console,
+// so the engines serve the interactive menu (search_algs.h), batch mode
+// (batch_solver.h) and any other caller alike.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <string>
+#include <queue>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include "packed_state.h"
+#include "node.h"
+#include "node_pool.h"
+#include "visited_set.h"
+#include "state_rank.h"
+#include "heuristics.h"
+#include "distance_db.h"
+#include "ida_star.h"
+#include "bidirectional.h"
+#include "search_stats.h"
+#include "goal_canonical.h"
+#include "bucket_queue.h"
+#include "move_string.h"
+#include "solvability.h"
+
+using namespace std;
+
+enum SearchEngine
+{
+	ENGINE_BFS,
+	ENGINE_GREEDY,			// Greedy best-first (h only)
+	ENGINE_ASTAR,
+	ENGINE_IDASTAR,
+	ENGINE_DATABASE,		// Distance database lookup, no search
+	ENGINE_BIDIRECTIONAL_BFS,
+	ENGINE_BIDIRECTIONAL_ASTAR	// Front-to-end, h toward the opposite root
+};
+
+struct SolverAlgorithm
+{
+	SearchEngine m_Engine;
+	HeuristicType m_Heuristic;	// Ignored by ENGINE_BFS, ENGINE_DATABASE and ENGINE_BIDIRECTIONAL_BFS
+};
+
+struct SearchResult
+{
+	MoveString m_Path;					// Solution from start to goal, 2 bits per move (see move_string.h)
+	SearchStats m_Stats;				// Counts, peaks and (if m_Stats.m_bTimed is set) phase times
+};
+
+//Reusable working memory for the engines. Keep one per thread and pass it to every
+//solve so blocks, tables and the database are allocated once rather than per puzzle.
+struct SearchContext
+{
+	NodePool m_Pool;
+	VisitedSet m_Visited;
+	VisitedSet m_BackwardVisited;		// Goal side of the bidirectional searches
+	VisitedBitmap m_Bitmap;
+	BucketQueue<Node*> m_OpenList;		// Best-first open list, by f (or h) then deepest first
+	DistanceDatabase m_Database;		// Opened for the goal on first use
+	Heuristic m_Heuristic;				// Tables for the last goal and heuristic solved for
+	Heuristic m_BackwardHeuristic;		// Tables toward the start, for bidirectional A*
+	SolvabilityFilter m_Solvability;	// Parity of the last goal solved for
+};
+
+//Held while a context opens a database, so threads never build the same file at once
+mutex g_DatabaseLock;
+
+bool getSolverAlgorithm(string name, SolverAlgorithm &algorithm); //Maps bfs, greedy, astar, ida, db, bibfs, biastar (with -toop/-lc/-wd) to an algorithm
+void clearSearchResult(SearchResult &result);
+Heuristic &getContextHeuristic(SearchContext &ctx, PackedState goal, HeuristicType type); //Rebuilds ctx's tables only if goal or type changed
+Heuristic &getCachedHeuristic(Heuristic &heuristic, PackedState goal, HeuristicType type); //Rebuilds heuristic only if goal or type changed
+bool solvePuzzle(PackedState start, PackedState goal, SolverAlgorithm algorithm, SearchContext &ctx, SearchResult &result); //Returns false if unsolvable
+bool solveBFS(PackedState start, PackedState goal, SearchContext &ctx, SearchResult &result);
+bool solveBestFirst(PackedState start, PackedState goal, HeuristicType heuristic, bool bAStar, SearchContext &ctx, SearchResult &result);
+
+//Maps an algorithm name to an algorithm. Names are an engine, optionally followed by
+//a heuristic suffix: bfs, db, bibfs, greedy, astar, ida, biastar, and -toop, -lc, -wd or -pdb (Manhattan by default)
+bool getSolverAlgorithm(string name, SolverAlgorithm &algorithm)
+{
+	algorithm.m_Heuristic = H_MANHATTAN;
+	string strEngine = name;
+	size_t nDash = name.find('-');
+	if (nDash != string::npos)
+	{
+		strEngine = name.substr(0, nDash);
+		string strHeuristic = name.substr(nDash + 1);
+		if (strHeuristic == "toop")
+			algorithm.m_Heuristic = H_MISPLACED;
+		else if (strHeuristic == "lc")
+			algorithm.m_Heuristic = H_LINEAR_CONFLICT;
+		else if (strHeuristic == "wd")
+			algorithm.m_Heuristic = H_WALKING_DISTANCE;
+		else if (strHeuristic == "pdb")
+			algorithm.m_Heuristic = H_PATTERN_DB;
+		else if (strHeuristic != "manhattan")
+			return false;
+	}
+
+	if (strEngine == "bfs" && nDash == string::npos)
+		algorithm.m_Engine = ENGINE_BFS;
+	else if (strEngine == "db" && nDash == string::npos)
+		algorithm.m_Engine = ENGINE_DATABASE;
+	else if (strEngine == "bibfs" && nDash == string::npos)
+		algorithm.m_Engine = ENGINE_BIDIRECTIONAL_BFS;
+	else if (strEngine == "greedy")
+		algorithm.m_Engine = ENGINE_GREEDY;
+	else if (strEngine == "astar")
+		algorithm.m_Engine = ENGINE_ASTAR;
+	else if (strEngine == "ida")
+		algorithm.m_Engine = ENGINE_IDASTAR;
+	else if (strEngine == "biastar")
+		algorithm.m_Engine = ENGINE_BIDIRECTIONAL_ASTAR;
+	else
+		return false;
+	return true;
+}
+
+void clearSearchResult(SearchResult &result)
+{
+	result.m_Path.clear();
+	clearSearchStats(result.m_Stats);
+}
+
+//Returns ctx's heuristic tables for goal and type, building them only when either
+//differs from the last call
+Heuristic &getContextHeuristic(SearchContext &ctx, PackedState goal, HeuristicType type)
+{
+	return getCachedHeuristic(ctx.m_Heuristic, goal, type);
+}
+
+Heuristic &getCachedHeuristic(Heuristic &heuristic, PackedState goal, HeuristicType type)
+{
+	if (heuristic.getGoal() != goal || heuristic.getType() != type)
+		heuristic.build(goal, type);
+	return heuristic;
+}
+
+//Solves with the given algorithm. Returns false if goal is unreachable from start.
+//The puzzle is first turned into the equivalent one for goal's canonical goal (see
+//goal_canonical.h), so databases and heuristic tables in ctx are built for at most
+//three goals however many goals are solved for, and the moves are mapped back after.
+bool solvePuzzle(PackedState start, PackedState goal, SolverAlgorithm algorithm, SearchContext &ctx, SearchResult &result)
+{
+	clearSearchResult(result);
+	ctx.m_Solvability.setGoal(goal);
+	if (!ctx.m_Solvability.isSolvable(start))
+		return false; //different parity classes, no search could succeed
+
+	GoalCanonicalizer<3> canon;
+	buildGoalCanonicalizer(goal, canon);
+	start = canonicalizeState(canon, start);
+	goal = getCanonicalGoal(canon);
+
+	bool bSolved = false;
+	switch (algorithm.m_Engine)
+	{
+	case ENGINE_BFS:
+		bSolved = solveBFS(start, goal, ctx, result);
+		break;
+	case ENGINE_GREEDY:
+		bSolved = solveBestFirst(start, goal, algorithm.m_Heuristic, false, ctx, result);
+		break;
+	case ENGINE_ASTAR:
+		bSolved = solveBestFirst(start, goal, algorithm.m_Heuristic, true, ctx, result);
+		break;
+	case ENGINE_IDASTAR:
+		bSolved = solveIDAStar(start, getContextHeuristic(ctx, goal, algorithm.m_Heuristic), result.m_Path, result.m_Stats);
+		break;
+	case ENGINE_DATABASE:
+		if (!ctx.m_Database.isOpen() || ctx.m_Database.getGoal() != goal)
+		{
+			lock_guard<mutex> lock(g_DatabaseLock);
+			if (!ctx.m_Database.open(goal))
+				return false;
+		}
+		bSolved = ctx.m_Database.solve(start, result.m_Path);
+		break;
+	case ENGINE_BIDIRECTIONAL_BFS:
+		bSolved = solveBidirectionalBFS(start, goal, ctx.m_Pool, ctx.m_Visited, ctx.m_BackwardVisited, result.m_Path, result.m_Stats);
+		break;
+	case ENGINE_BIDIRECTIONAL_ASTAR:
+		bSolved = solveBidirectionalAStar(start, goal, getContextHeuristic(ctx, goal, algorithm.m_Heuristic), getCachedHeuristic(ctx.m_BackwardHeuristic, start, algorithm.m_Heuristic),
+			ctx.m_Pool, ctx.m_Visited, ctx.m_BackwardVisited, result.m_Path, result.m_Stats);
+		break;
+	}
+	restoreMoves(canon, result.m_Path);
+	return bSolved;
+}
+
+//Attempts to solve puzzle with BFS.
+//The BFS uses a FIFO queue and does not assign any cost to the nodes.
+//Duplicates are detected with a bitmap indexed by state rank (see state_rank.h).
+//  This is the only difference between solveBFS() and solveBestFirst()
+bool solveBFS(PackedState start, PackedState goal, SearchContext &ctx, SearchResult &result)
+{
+	clearSearchResult(result);
+	SearchStats &stats = result.m_Stats;
+	if (start == goal)
+		return true;
+
+	//Create root node, open list, and closed list
+	NodePool &pool = ctx.m_Pool; //every node of this search lives here and is released by the next search
+	VisitedBitmap &visited = ctx.m_Bitmap; //one bit per state rank, set once the state is added to the open list (open + closed)
+	pool.releaseAll();
+	visited.clear();
+	Node* node = pool.createNode(start);
+	queue<Node*> qOpenList;
+
+	//Root state is not goal state, so continue with Breadth First Search by
+	//  adding the current state to the open list and then doing our BFS.
+	qOpenList.push(node);
+	visited.testAndSet(rankState(node->getState()));
+
+	while (true)
+	{
+		if (qOpenList.empty())
+		{
+			stats.m_nPeakClosed = visited.getCount();
+			return false; //if the open list is empty, we failed at solving
+		}
+		{
+			PhaseTimer timer(stats, PHASE_QUEUE);
+			node = qOpenList.front();
+			qOpenList.pop();
+		}
+		stats.m_nExpanded++;
+
+		//possible moves for this state, looked up by its blank position (see packed_state.h)
+		PackedState state = node->getState(); //packed current state, with its blank position cached
+		const PackedMoves &moves = getPackedMoves(state);
+
+		for (int i = 0; i < moves.m_nCount; i++) //for each action in Actions(node.state) do:
+		{
+			//Creates new child node with the state of having made the current move
+			//(When the nodes "child" constructor is called here, the move is performed)
+			Node* child;
+			{
+				PhaseTimer timer(stats, PHASE_EXPAND);
+				child = pool.createNode(state, moves.m_nMoves[i], node);
+			}
+			stats.m_nGenerated++;
+
+			//look for state in the visited bitmap (open and closed lists).
+			//  If it is marked we don't do anything with it. If it isn't we check for sol and add to queue
+			bool bNew;
+			{
+				PhaseTimer timer(stats, PHASE_DUPLICATE);
+				bNew = visited.testAndSet(rankState(child->getState()));
+			}
+			if (bNew)
+			{
+				if (child->getState() == goal)
+				{
+					stats.m_nPeakClosed = visited.getCount();
+					getPathMoves(child, result.m_Path);
+					return true;
+				}
+				else
+				{
+					PhaseTimer timer(stats, PHASE_QUEUE);
+					qOpenList.push(child);
+					updateSearchPeak(stats.m_nPeakOpen, qOpenList.size());
+				}
+			}
+			else
+			{
+				stats.m_nDuplicates++;
+				pool.releaseLast(); //give the node back since we're not going to use it
+			}
+		}
+	}
+}
+
+//Attempts to solve puzzle with a best-first search ordered by the given heuristic.
+//Heuristic tables are built once per goal and kept in ctx (see heuristics.h)
+//With bAStar nodes are ordered by depth + h, else by h alone (greedy).
+//The visited set maps each state to the node holding its best known path cost (g).
+//  A* re-opens a state whenever a cheaper path to it is found; the
+//  node it replaces is left in the open list and skipped when popped (lazy deletion).
+//  The goal test is done when a node is popped, so with an admissible heuristic
+//  the first solution found is optimal. The greedy search never re-opens.
+//The open list is a bucket queue (see bucket_queue.h): among nodes of equal cost the
+//deepest is taken first, so fewer nodes of the final f layer are expanded.
+bool solveBestFirst(PackedState start, PackedState goal, HeuristicType heuristicType, bool bAStar, SearchContext &ctx, SearchResult &result)
+{
+	clearSearchResult(result);
+	SearchStats &stats = result.m_Stats;
+
+	//Create root node, open list, and closed list
+	NodePool &pool = ctx.m_Pool; //every node of this search lives here and is released by the next search
+	VisitedSet &visited = ctx.m_Visited; //every state ever added to the open list, i.e. open + closed, with its best node
+	pool.releaseAll();
+	visited.clear();
+	Node* node = pool.createNode(start);
+	BucketQueue<Node*> &qOpenList = ctx.m_OpenList; //buckets by total cost, then by depth with the deepest first
+	qOpenList.clear();
+
+	//Heuristic tables for this goal. Children update h from their parent's
+	Heuristic &heuristic = getContextHeuristic(ctx, goal, heuristicType);
+	uint32_t nKey;
+	int h = heuristic.evaluate(node->getState(), nKey);
+	node->setHeuristic(h, nKey);
+	stats.m_nHeuristicEvaluations++;
+
+	qOpenList.push(node, h, 0);
+	visited.insert(node->getState(), node);
+
+	while (true)
+	{
+		if (qOpenList.empty())
+		{
+			stats.m_nPeakClosed = visited.getSize();
+			return false; //if the open list is empty, we failed at solving
+		}
+		{
+			PhaseTimer timer(stats, PHASE_QUEUE);
+			node = qOpenList.top();
+			qOpenList.pop();
+		}
+
+		//skip nodes superseded by a cheaper path to the same state
+		PackedState state = node->getState(); //packed current state, with its blank position cached
+		{
+			PhaseTimer timer(stats, PHASE_DUPLICATE);
+			if (visited.find(state) != node)
+				continue;
+		}
+
+		if (state == goal)
+		{
+			stats.m_nPeakClosed = visited.getSize();
+			getPathMoves(node, result.m_Path);
+			return true;
+		}
+		stats.m_nExpanded++;
+
+		//possible moves for this state, looked up by its blank position (see packed_state.h)
+		const PackedMoves &moves = getPackedMoves(state);
+
+		int nChildDepth = node->getDepth() + 1;
+		for (int i = 0; i < moves.m_nCount; i++) //for each action in Actions(node.state) do:
+		{
+			//look for the child's state in the visited set (open and closed lists).
+			//  If it exists with an equal or cheaper path we don't do anything with it.
+			int move = moves.m_nMoves[i];
+			PackedState childState;
+			{
+				PhaseTimer timer(stats, PHASE_EXPAND);
+				childState = slidePackedTile(state, move);
+			}
+			stats.m_nGenerated++;
+			Node* pBest;
+			{
+				PhaseTimer timer(stats, PHASE_DUPLICATE);
+				pBest = visited.find(childState);
+			}
+			if (pBest != nullptr && (!bAStar || pBest->getDepth() <= nChildDepth))
+			{
+				stats.m_nDuplicates++;
+				continue;
+			}
+
+			//Creates new child node with the state of having made the current move
+			//(When the nodes "child" constructor is called here, the move is performed)
+			Node* child;
+			{
+				PhaseTimer timer(stats, PHASE_EXPAND);
+				child = pool.createNode(state, move, node);
+			}
+
+			//h is updated from the parent's value and key (see heuristics.h)
+			{
+				PhaseTimer timer(stats, PHASE_HEURISTIC);
+				uint32_t nChildKey = node->getHeuristicKey();
+				int nChildH = heuristic.getChildValue(state, node->getHeuristic(), nChildKey, childState);
+				child->setHeuristic(nChildH, nChildKey);
+			}
+			stats.m_nHeuristicEvaluations++;
+			if (bAStar)
+				child->setTotalCost(nChildDepth + child->getHeuristic());
+			else
+				child->setTotalCost(child->getHeuristic());
+
+			{
+				PhaseTimer timer(stats, PHASE_DUPLICATE);
+				if (pBest == nullptr)
+					visited.insert(childState, child);
+				else
+				{
+					visited.replace(childState, child); //re-open with the cheaper path
+					stats.m_nReopened++;
+				}
+			}
+
+			PhaseTimer timer(stats, PHASE_QUEUE);
+			qOpenList.push(child, child->getTotalCost(), nChildDepth);
+			updateSearchPeak(stats.m_nPeakOpen, qOpenList.size());
+		}
+	}
+}
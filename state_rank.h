@@ -0,0 +1,170 @@
+/////////////////////////////////////////////////////////////
+// Perfect hashing of board states for eight_tile_solver.
+//
+// Only 9!/2 = 181,440 states are reachable from any board: those whose tiles
+// (ignoring the blank) have the same inversion parity. rankState() maps each
+// of them to a unique index in [0, 181440) and unrankState() reverses it:
+//   rank = blank position * 20160 + (Lehmer code of the 8 tiles) / 2
+// The last Lehmer digit is dropped because parity determines it. Any table
+// indexed by state (visited bitmap, distance database) can use the rank.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include "packed_state.h"
+
+using namespace std;
+
+#define NUM_STATE_RANKS 181440	// 9!/2 reachable states per parity class
+#define NUM_TILE_RANKS 20160	// 8!/2 tile orders per blank position
+
+int countBits(unsigned int n); //Returns the number of set bits in n
+int getStateParity(PackedState state); //Returns inversion parity (0 or 1) of the tiles, ignoring the blank
+int rankState(PackedState state); //Returns the rank of state within its parity class
+PackedState unrankState(int rank, int parity); //Returns the state of the given rank and parity class
+
+class VisitedBitmap
+{
+public:
+	VisitedBitmap();								//Starts with every bit clear
+	bool testAndSet(int rank);						//Sets the bit for rank. Returns false if it was already set
+	bool test(int rank);
+	void clear();
+	unsigned int getCount();						//Number of bits set
+
+protected:
+	uint64_t m_nWords[NUM_STATE_RANKS / 64];		// 2835 words, about 22 KB
+	unsigned int m_nCount;
+};
+
+//Returns the number of set bits in n
+int countBits(unsigned int n)
+{
+	n = n - ((n >> 1) & 0x55555555);
+	n = (n & 0x33333333) + ((n >> 2) & 0x33333333);
+	n = (n + (n >> 4)) & 0x0F0F0F0F;
+	return (int)((n * 0x01010101) >> 24);
+}
+
+//Returns inversion parity of the tiles in reading order, ignoring the blank.
+//Two boards are reachable from each other iff their parities match.
+//The earlier tiles larger than each tile are the bits of nSeen >> tile, and the
+//parity of a sum of bit counts is the parity of the bit count of their XOR, so
+//the bits are XORed together and counted once. Counting the blank as tile 0
+//adds one inversion per tile before it, which its position takes back out.
+int getStateParity(PackedState state)
+{
+	unsigned int nSeen = 0; //bit t set once tile t has been read
+	unsigned int nLarger = 0;
+	uint64_t nTiles = state.m_nTiles;
+	for (int i = 0; i < 9; i++, nTiles >>= TILE_BITS)
+	{
+		int nTile = (int)(nTiles & TILE_MASK);
+		nLarger ^= nSeen >> nTile;
+		nSeen |= 1u << nTile;
+	}
+	return (countBits(nLarger) ^ state.m_nBlank) & 1;
+}
+
+//Returns the rank of state within its parity class, in [0, NUM_STATE_RANKS)
+int rankState(PackedState state)
+{
+	//Lehmer digit of each tile = number of smaller tiles not yet seen.
+	//Digits have radix 8,7,...,1 and the last two (radix 2 and 1) are implied.
+	unsigned int nSeen = 0;
+	int nRank = 0;
+	int nDigit = 0;
+	for (int i = 0; i < 9; i++)
+	{
+		int nTile = getPackedTile(state, i);
+		if (nTile == 0)
+			continue;
+		int nValue = nTile - 1;
+		if (nDigit < 6)
+			nRank = nRank * (8 - nDigit) + nValue - countBits(nSeen & ((1u << nValue) - 1));
+		nSeen |= 1u << nValue;
+		nDigit++;
+	}
+	return state.m_nBlank * NUM_TILE_RANKS + nRank;
+}
+
+//Returns the state of the given rank within the given parity class
+PackedState unrankState(int rank, int parity)
+{
+	int nBlank = rank / NUM_TILE_RANKS;
+	int nRank = rank % NUM_TILE_RANKS;
+
+	//Recover the first six Lehmer digits, then pick the seventh to match parity
+	int nDigits[8];
+	for (int i = 5; i >= 0; i--)
+	{
+		nDigits[i] = nRank % (8 - i);
+		nRank /= 8 - i;
+	}
+	int nSum = 0;
+	for (int i = 0; i < 6; i++)
+		nSum += nDigits[i];
+	nDigits[6] = (nSum & 1) ^ parity;
+	nDigits[7] = 0;
+
+	//Convert digits back to tiles, then lay them out around the blank
+	int nState[9];
+	unsigned int nUsed = 0;
+	int nPos = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		int nValue = 0;
+		for (int nSkip = nDigits[i]; ; nValue++)
+		{
+			if (nUsed & (1u << nValue))
+				continue;
+			if (nSkip-- == 0)
+				break;
+		}
+		nUsed |= 1u << nValue;
+		if (nPos == nBlank)
+			nState[nPos++] = 0;
+		nState[nPos++] = nValue + 1;
+	}
+	if (nPos == nBlank)
+		nState[nPos] = 0;
+	return packState(nState);
+}
+
+//Constructor
+VisitedBitmap::VisitedBitmap()
+{
+	clear();
+}
+
+//Sets the bit for rank. Returns false if it was already set
+bool VisitedBitmap::testAndSet(int rank)
+{
+	uint64_t nBit = 1ULL << (rank & 63);
+	uint64_t &nWord = m_nWords[rank >> 6];
+	if (nWord & nBit)
+		return false;
+	nWord |= nBit;
+	m_nCount++;
+	return true;
+}
+
+bool VisitedBitmap::test(int rank)
+{
+	return (m_nWords[rank >> 6] >> (rank & 63)) & 1;
+}
+
+void VisitedBitmap::clear()
+{
+	for (int i = 0; i < NUM_STATE_RANKS / 64; i++)
+		m_nWords[i] = 0;
+	m_nCount = 0;
+}
+
+unsigned int VisitedBitmap::getCount()
+{
+	return m_nCount;
+}
@@ -0,0 +1,843 @@
+/////////////////////////////////////////////////////////////
+// Unit tests for eight_tile_solver.
+//
+// Checks the pure building blocks the engines rely on against brute force or
+// round trips, so a change to one of them is caught without running a search,
+// then checks the engines and heuristics against the 8-puzzle distance
+// database, which writes its table and two small pattern tables to the
+// current directory as the solver does.
+// Random boards come from a fixed seed, so every run checks the same cases.
+// Prints every failed check and a count, and exits with 1 if any failed.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2017
+
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <set>
+#include <vector>
+#include <tuple>
+#include "nxn_board.h"
+#include "packed_state.h"
+#include "move_string.h"
+#include "goal_canonical.h"
+#include "bucket_queue.h"
+#include "simd_heuristics.h"
+#include "state_rank.h"
+#include "solvability.h"
+#include "result_writer.h"
+#include "solvers.h"
+#include "parallel_bfs.h"
+#include "nxn_search.h"
+#include "pattern_db.h"
+
+using namespace std;
+
+#define CHECK(expr) checkResult((expr), #expr, __FILE__, __LINE__)
+#define TEST_SEED 2017
+#define TEST_ENGINE_STARTS 200	// Sampled starts per goal in testEngines
+
+int g_nChecks = 0;
+int g_nFailures = 0;
+mt19937_64 g_Rng(TEST_SEED);
+
+void checkResult(bool bPassed, const char* chExpr, const char* chFile, int nLine);
+template<int N> void shuffleTiles(int tiles[N * N]); //Fills tiles with a random arrangement of 0..N*N-1, solvable or not
+template<int N> void testBoardPacking();
+template<int N> void testBoardMoves();
+template<int N> MoveString getRandomWalk(BoardState<N> board, int nLength); //nLength random legal moves from board
+void testPackedCanonicalizer();
+template<int N> void testBoardCanonicalizer();
+void testBucketQueue();
+void testMoveString();
+bool isSameMoves(const MoveString &moves, const vector<int> &vReference);
+int getTileCost(const int nStart[9], const int nGoal[9], HeuristicType type); //Sum over non-blank tiles, from the tile arrays alone
+void testBatchHeuristics();
+template<int N> int getInversionParity(const int tiles[N * N]); //Inversions of the non-blank tiles, plus the blank's row when N is even, mod 2
+template<int N> void testBoardParity();
+void testStateRanks();
+uint64_t readLittleEndian(const string &record, int nOffset, int nBytes);
+bool isZero(const string &record, int nFirst, int nEnd); //True if bytes [nFirst, nEnd) are all 0
+template<int N> void testBinaryRecords();
+void testTextRecords();
+void getTestPatternGroups(vector< vector<int> > &vGroups); //1-4 and 5-8, small enough to build in a moment
+template<int N, class H> void checkBoardSolves(const BoardState<N> &start, H &heuristic, BoardSearchContext<N> &ctx, int nDistance); //NxN IDA* and A* both find an optimal path that replays to the goal
+void testEngines();
+template<class H> bool isBoardHeuristicExact(H &heuristic, PackedState goal, DistanceDatabase &db, bool &bIncremental); //True if h <= distance over goal's class; bIncremental is cleared if a child's h differs from a full evaluation
+void testHeuristicBounds();
+template<int N> void testBoardVisitedSet();
+void testSearchMemory();
+
+void checkResult(bool bPassed, const char* chExpr, const char* chFile, int nLine)
+{
+	g_nChecks++;
+	if (bPassed)
+		return;
+	g_nFailures++;
+	cout << chFile << ":" << nLine << ": failed: " << chExpr << "\n";
+}
+
+template<int N>
+void shuffleTiles(int tiles[N * N])
+{
+	for (int p = 0; p < N * N; p++)
+		tiles[p] = p;
+	for (int p = N * N - 1; p > 0; p--)
+		swap(tiles[p], tiles[g_Rng() % (p + 1)]);
+}
+
+//Packing and unpacking give back every tile and find the blank
+template<int N>
+void testBoardPacking()
+{
+	for (int i = 0; i < 1000; i++)
+	{
+		int nTiles[N * N];
+		int nUnpacked[N * N];
+		shuffleTiles<N>(nTiles);
+		BoardState<N> board = packBoard<N>(nTiles);
+		unpackBoard<N>(board, nUnpacked);
+		CHECK(equal(nTiles, nTiles + N * N, nUnpacked));
+		CHECK(getBoardTile(board, board.m_nBlank) == 0);
+	}
+}
+
+//A move is legal exactly when the blank has a neighbor on that side, the legal move
+//list holds those moves, each move swaps the blank with the tile it names, and the
+//inverse move (move ^ 1) restores the board
+template<int N>
+void testBoardMoves()
+{
+	for (int i = 0; i < 1000; i++)
+	{
+		int nTiles[N * N];
+		shuffleTiles<N>(nTiles);
+		BoardState<N> board = packBoard<N>(nTiles);
+		int nRow = board.m_nBlank / N;
+		int nCol = board.m_nBlank % N;
+		bool bLegal[4] = { nCol < N - 1, nCol > 0, nRow < N - 1, nRow > 0 }; //left, right, up, down
+		int nLegal = 0;
+		for (int move = 0; move < 4; move++)
+		{
+			CHECK(isBoardMoveLegal(board, move) == bLegal[move]);
+			nLegal += bLegal[move];
+		}
+
+		const BoardMoves &moves = getBoardMoves(board);
+		CHECK(moves.m_nCount == nLegal);
+		for (int m = 0; m < moves.m_nCount; m++)
+		{
+			int move = moves.m_nMoves[m];
+			CHECK(bLegal[move]);
+			int nTarget = BoardConstants<N>::s_Tables.m_nMoveTarget[board.m_nBlank][move];
+			BoardState<N> child = slideBoardTile(board, move);
+			CHECK(child.m_nBlank == nTarget);
+			CHECK(getBoardTile(child, board.m_nBlank) == getBoardTile(board, nTarget));
+			CHECK(isBoardMoveLegal(child, move ^ 1));
+			CHECK(slideBoardTile(child, move ^ 1) == board);
+		}
+	}
+}
+
+template<int N>
+MoveString getRandomWalk(BoardState<N> board, int nLength)
+{
+	MoveString path;
+	for (int i = 0; i < nLength; i++)
+	{
+		const BoardMoves &moves = getBoardMoves(board);
+		int move = moves.m_nMoves[g_Rng() % moves.m_nCount];
+		path.push_back(move);
+		board = slideBoardTile(board, move);
+	}
+	return path;
+}
+
+//Every goal maps to the canonical goal for its blank's square, and moves made on the
+//canonical board, once restored, lead the original start to the matching state
+void testPackedCanonicalizer()
+{
+	int nCorner[9] = { 1, 2, 3, 4, 5, 6, 7, 8, 0 };
+	int nEdge[9] = { 1, 2, 3, 4, 5, 6, 7, 0, 8 };
+	int nCenter[9] = { 1, 2, 3, 4, 0, 5, 6, 7, 8 };
+	PackedState canonicalGoals[3] = { packState(nCorner), packState(nEdge), packState(nCenter) };
+	for (int i = 0; i < 1000; i++)
+	{
+		int nGoal[9];
+		int nStart[9];
+		shuffleTiles<3>(nGoal);
+		shuffleTiles<3>(nStart);
+		PackedState goal = packState(nGoal);
+		PackedState start = packState(nStart);
+		GoalCanonicalizer<3> canon;
+		buildGoalCanonicalizer(goal, canon);
+		PackedState canonicalGoal = getCanonicalGoal(canon);
+		CHECK(canonicalizeState(canon, goal) == canonicalGoal);
+		CHECK(canonicalGoal == canonicalGoals[0] || canonicalGoal == canonicalGoals[1] || canonicalGoal == canonicalGoals[2]);
+
+		PackedState canonicalStart = canonicalizeState(canon, start);
+		int nCanonical[9];
+		unpackState(canonicalStart, nCanonical);
+		MoveString path = getRandomWalk<3>(packBoard<3>(nCanonical), 40);
+		PackedState canonicalEnd = replayMoves(canonicalStart, path);
+		restoreMoves(canon, path);
+		CHECK(canonicalizeState(canon, replayMoves(start, path)) == canonicalEnd);
+	}
+}
+
+//As above, for NxN boards
+template<int N>
+void testBoardCanonicalizer()
+{
+	for (int i = 0; i < 300; i++)
+	{
+		int nGoal[N * N];
+		int nStart[N * N];
+		shuffleTiles<N>(nGoal);
+		shuffleTiles<N>(nStart);
+		BoardState<N> goal = packBoard<N>(nGoal);
+		BoardState<N> start = packBoard<N>(nStart);
+		GoalCanonicalizer<N> canon;
+		buildGoalCanonicalizer(goal, canon);
+		BoardState<N> canonicalGoal = getCanonicalBoardGoal(canon);
+		CHECK(canonicalizeBoard(canon, goal) == canonicalGoal);
+		for (int p = 0; p < N * N; p++)
+		{
+			if (p != canonicalGoal.m_nBlank)
+				CHECK(getBoardTile(canonicalGoal, p) == p + 1 - (p > canonicalGoal.m_nBlank)); //1, 2, ... in reading order around the blank
+		}
+
+		BoardState<N> canonicalStart = canonicalizeBoard(canon, start);
+		MoveString path = getRandomWalk<N>(canonicalStart, 60);
+		BoardState<N> canonicalEnd = replayBoardMoves(canonicalStart, path);
+		restoreMoves(canon, path);
+		CHECK(canonicalizeBoard(canon, replayBoardMoves(start, path)) == canonicalEnd);
+	}
+}
+
+//Interleaved pushes and pops come out by lowest priority, then highest tie-break, then
+//last in first out, as a sorted set of (priority, -tie-break, -push number) orders them
+void testBucketQueue()
+{
+	BucketQueue<int> queue;
+	for (int nRound = 0; nRound < 20; nRound++)
+	{
+		set< tuple<int, int, int> > reference;
+		int nPushed = 0;
+		for (int i = 0; i < 2000; i++)
+		{
+			if (reference.empty() || g_Rng() % 3 != 0)
+			{
+				int nPriority = (int)(g_Rng() % 40);
+				int nTie = (int)(g_Rng() % 8);
+				queue.push(nPushed, nPriority, nTie);
+				reference.insert(make_tuple(nPriority, -nTie, -nPushed));
+				nPushed++;
+			}
+			else
+			{
+				CHECK(queue.getTopPriority() == get<0>(*reference.begin()));
+				CHECK(queue.top() == -get<2>(*reference.begin()));
+				queue.pop();
+				reference.erase(reference.begin());
+			}
+			CHECK(queue.size() == reference.size());
+		}
+		queue.clear(); //the next round reuses the buckets
+		CHECK(queue.empty());
+	}
+}
+
+bool isSameMoves(const MoveString &moves, const vector<int> &vReference)
+{
+	if (moves.size() != vReference.size() || moves.empty() != vReference.empty())
+		return false;
+	for (size_t i = 0; i < vReference.size(); i++)
+	{
+		if (moves[i] != vReference[i])
+			return false;
+	}
+	return true;
+}
+
+//Random edits across word boundaries (32 moves per word) match a vector of ints,
+//including moves left in a word by pop_back or clear, and packed and board replays agree
+void testMoveString()
+{
+	MoveString moves;
+	vector<int> vReference;
+	for (int i = 0; i < 20000; i++)
+	{
+		int nOp = (int)(g_Rng() % 10);
+		int move = (int)(g_Rng() % 4);
+		if (nOp < 5 || vReference.empty())
+		{
+			moves.push_back(move);
+			vReference.push_back(move);
+		}
+		else if (nOp < 7)
+		{
+			moves.pop_back();
+			vReference.pop_back();
+		}
+		else if (nOp == 7)
+		{
+			size_t nIndex = g_Rng() % vReference.size();
+			moves.set(nIndex, move);
+			vReference[nIndex] = move;
+		}
+		else if (nOp == 8)
+		{
+			size_t nSize = g_Rng() % 100;
+			moves.resize(nSize);
+			vReference.resize(nSize, 0);
+		}
+		else
+		{
+			moves.reverse();
+			reverse(vReference.begin(), vReference.end());
+		}
+		CHECK(isSameMoves(moves, vReference));
+		if (g_Rng() % 500 == 0)
+		{
+			moves.clear();
+			vReference.clear();
+		}
+	}
+
+	int nTiles[9];
+	shuffleTiles<3>(nTiles);
+	BoardState<3> board = packBoard<3>(nTiles);
+	MoveString path = getRandomWalk<3>(board, 200);
+	int nEnd[9];
+	unpackBoard<3>(replayBoardMoves(board, path), nEnd);
+	CHECK(replayMoves(packState(nTiles), path) == packState(nEnd));
+}
+
+int getTileCost(const int nStart[9], const int nGoal[9], HeuristicType type)
+{
+	int nCost = 0;
+	for (int p = 0; p < 9; p++)
+	{
+		if (nStart[p] == 0)
+			continue;
+		int g = (int)(find(nGoal, nGoal + 9, nStart[p]) - nGoal);
+		if (type == H_MISPLACED)
+			nCost += (g != p);
+		else
+			nCost += abs(g / 3 - p / 3) + abs(g % 3 - p % 3);
+	}
+	return nCost;
+}
+
+//Every SIMD level the CPU runs, scalar included, scores random states against a tile by
+//tile count, with batch sizes that leave a partial vector at the end
+void testBatchHeuristics()
+{
+	HeuristicType types[2] = { H_MANHATTAN, H_MISPLACED };
+	for (int i = 0; i < 200; i++)
+	{
+		int nGoal[9];
+		shuffleTiles<3>(nGoal);
+		size_t nCount = 1 + g_Rng() % 67;
+		vector<PackedState> vStates(nCount);
+		vector< vector<int> > vTiles(nCount, vector<int>(9));
+		for (size_t s = 0; s < nCount; s++)
+		{
+			shuffleTiles<3>(&vTiles[s][0]);
+			vStates[s] = packState(&vTiles[s][0]);
+		}
+
+		for (int t = 0; t < 2; t++)
+		{
+			BatchTileHeuristic kernel;
+			CHECK(kernel.build(packState(nGoal), types[t]));
+			for (int level = SIMD_SCALAR; level <= getSupportedSimdLevel(); level++)
+			{
+				kernel.setSimdLevel((SimdLevel)level);
+				CHECK(kernel.getSimdLevel() == level);
+				vector<int> vValues(nCount, -1);
+				kernel.evaluate(&vStates[0], nCount, &vValues[0]);
+				for (size_t s = 0; s < nCount; s++)
+					CHECK(vValues[s] == getTileCost(&vTiles[s][0], nGoal, types[t]));
+			}
+		}
+	}
+}
+
+template<int N>
+int getInversionParity(const int tiles[N * N])
+{
+	int nInversions = 0;
+	int nBlank = 0;
+	for (int p = 0; p < N * N; p++)
+	{
+		if (tiles[p] == 0)
+		{
+			nBlank = p;
+			continue;
+		}
+		for (int q = p + 1; q < N * N; q++)
+			nInversions += (tiles[q] != 0 && tiles[q] < tiles[p]);
+	}
+	if (N % 2 == 0)
+		nInversions += nBlank / N;
+	return nInversions % 2;
+}
+
+//Parity is kept by every move, flips when two tiles swap places, and splits boards as
+//brute force counting does, and the solvability filter agrees with it
+template<int N>
+void testBoardParity()
+{
+	BoardSolvabilityFilter<N> solvability;
+	for (int i = 0; i < 1000; i++)
+	{
+		int nTiles[N * N];
+		int nGoal[N * N];
+		shuffleTiles<N>(nTiles);
+		shuffleTiles<N>(nGoal);
+		BoardState<N> board = packBoard<N>(nTiles);
+		BoardState<N> goal = packBoard<N>(nGoal);
+		bool bSameClass = (getInversionParity<N>(nTiles) == getInversionParity<N>(nGoal));
+		CHECK((getBoardParity(board) == getBoardParity(goal)) == bSameClass);
+		solvability.setGoal(goal);
+		CHECK(solvability.isSolvable(board) == bSameClass);
+
+		MoveString path = getRandomWalk<N>(board, 25);
+		CHECK(getBoardParity(replayBoardMoves(board, path)) == getBoardParity(board));
+
+		int p = (int)(g_Rng() % (N * N));
+		int q = (int)(g_Rng() % (N * N - 1));
+		q += (q >= p);
+		if (nTiles[p] != 0 && nTiles[q] != 0)
+		{
+			swap(nTiles[p], nTiles[q]);
+			CHECK(getBoardParity(packBoard<N>(nTiles)) != getBoardParity(board));
+		}
+	}
+}
+
+//Packed state parity matches brute force counting, and every rank of both parity classes
+//unranks to a state of that class which ranks back to it
+void testStateRanks()
+{
+	for (int i = 0; i < 1000; i++)
+	{
+		int nTiles[9];
+		shuffleTiles<3>(nTiles);
+		CHECK(getStateParity(packState(nTiles)) == getInversionParity<3>(nTiles));
+	}
+	for (int parity = 0; parity < 2; parity++)
+	{
+		bool bRoundTrips = true;
+		for (int rank = 0; rank < NUM_STATE_RANKS; rank++)
+		{
+			PackedState state = unrankState(rank, parity);
+			if (getStateParity(state) != parity || rankState(state) != rank)
+				bRoundTrips = false;
+		}
+		CHECK(bRoundTrips);
+	}
+}
+
+uint64_t readLittleEndian(const string &record, int nOffset, int nBytes)
+{
+	uint64_t nValue = 0;
+	for (int i = nBytes - 1; i >= 0; i--)
+		nValue = (nValue << 8) | (unsigned char)record[nOffset + i];
+	return nValue;
+}
+
+bool isZero(const string &record, int nFirst, int nEnd)
+{
+	for (int i = nFirst; i < nEnd; i++)
+	{
+		if (record[i] != 0)
+			return false;
+	}
+	return true;
+}
+
+//Binary records are read back byte by byte against the documented layout, for paths
+//on both sides of RESULT_MAX_MOVES and for unsolvable and invalid lines
+template<int N>
+void testBinaryRecords()
+{
+	ResultWriter writer(FORMAT_BINARY);
+	for (int i = 0; i < 200; i++)
+	{
+		int nTiles[N * N];
+		shuffleTiles<N>(nTiles);
+		MoveString path;
+		size_t nLength = g_Rng() % (RESULT_MAX_MOVES + 40);
+		for (size_t m = 0; m < nLength; m++)
+			path.push_back((int)(g_Rng() % 4));
+		SearchStats stats;
+		stats.m_nExpanded = g_Rng();
+
+		string record;
+		writer.appendSolved(record, "", nTiles, N, path, stats);
+		CHECK(record.size() == RESULT_RECORD_BYTES);
+		bool bTooLong = (nLength > RESULT_MAX_MOVES);
+		CHECK(record[0] == (bTooLong ? RESULT_TOO_LONG : RESULT_SOLVED));
+		CHECK(record[1] == N);
+		CHECK(readLittleEndian(record, 2, 2) == nLength);
+		CHECK(isZero(record, 4, 8));
+		CHECK(readLittleEndian(record, 8, 8) == stats.m_nExpanded);
+		for (int p = 0; p < N * N; p++)
+			CHECK(record[RESULT_TILES_OFFSET + p] == nTiles[p]);
+		CHECK(isZero(record, RESULT_TILES_OFFSET + N * N, RESULT_MOVES_OFFSET));
+		if (bTooLong)
+			CHECK(isZero(record, RESULT_MOVES_OFFSET, RESULT_RECORD_BYTES));
+		else
+		{
+			bool bSameMoves = true;
+			for (size_t m = 0; m < nLength; m++)
+			{
+				int move = ((unsigned char)record[RESULT_MOVES_OFFSET + m / 4] >> (2 * (m % 4))) & 3;
+				bSameMoves = bSameMoves && (move == path[m]);
+			}
+			CHECK(bSameMoves);
+			CHECK(isZero(record, RESULT_MOVES_OFFSET + (int)(nLength + 3) / 4, RESULT_RECORD_BYTES));
+		}
+
+		string unsolvable;
+		writer.appendUnsolvable(unsolvable, "", nTiles, N);
+		CHECK(unsolvable.size() == RESULT_RECORD_BYTES);
+		CHECK(unsolvable[0] == RESULT_UNSOLVABLE && unsolvable[1] == N);
+		CHECK(isZero(unsolvable, 2, RESULT_TILES_OFFSET));
+		CHECK(unsolvable.compare(RESULT_TILES_OFFSET, N * N, record, RESULT_TILES_OFFSET, N * N) == 0);
+		CHECK(isZero(unsolvable, RESULT_TILES_OFFSET + N * N, RESULT_RECORD_BYTES));
+	}
+
+	string invalid;
+	writer.appendInvalid(invalid, "not a board", N);
+	CHECK(invalid.size() == RESULT_RECORD_BYTES);
+	CHECK(invalid[0] == RESULT_INVALID && invalid[1] == N);
+	CHECK(isZero(invalid, 2, RESULT_RECORD_BYTES));
+}
+
+//Text and JSON records for one known solve, an unsolvable start and a line needing escapes
+void testTextRecords()
+{
+	int nTiles[9] = { 1, 2, 3, 4, 5, 6, 0, 7, 8 };
+	MoveString path;
+	path.push_back(1);
+	path.push_back(1);
+	SearchStats stats;
+	stats.m_nExpanded = 2;
+
+	ResultWriter text(FORMAT_TEXT);
+	string output;
+	text.appendSolved(output, "123456078", nTiles, 3, path, stats);
+	text.appendUnsolvable(output, "213456780", nTiles, 3);
+	text.appendInvalid(output, "12x", 3);
+	CHECK(output == "123456078 2 RR\n213456780 unsolvable\n12x invalid\n");
+
+	ResultWriter json(FORMAT_JSON);
+	output.clear();
+	json.appendSolved(output, "123456078", nTiles, 3, path, stats);
+	CHECK(output == "{\"start\":\"123456078\",\"status\":\"solved\",\"depth\":2,\"moves\":\"RR\",\"stats\":" + getSearchStatsJson(stats) + "}\n");
+	output.clear();
+	json.appendUnsolvable(output, "213456780", nTiles, 3);
+	json.appendInvalid(output, "a\"b\\c\t", 3);
+	CHECK(output == "{\"start\":\"213456780\",\"status\":\"unsolvable\"}\n{\"start\":\"a\\\"b\\\\c\\u0009\",\"status\":\"invalid\"}\n");
+}
+
+void getTestPatternGroups(vector< vector<int> > &vGroups)
+{
+	int nGroups[2][4] = { { 1, 2, 3, 4 }, { 5, 6, 7, 8 } };
+	vGroups.clear();
+	for (int g = 0; g < 2; g++)
+		vGroups.push_back(vector<int>(nGroups[g], nGroups[g] + 4));
+}
+
+template<int N, class H>
+void checkBoardSolves(const BoardState<N> &start, H &heuristic, BoardSearchContext<N> &ctx, int nDistance)
+{
+	MoveString path;
+	SearchStats stats;
+	CHECK(solveBoardIDAStar(start, heuristic, path, stats));
+	CHECK((int)path.size() == nDistance);
+	CHECK(replayBoardMoves(start, path) == heuristic.getGoal());
+	CHECK(solveBoardAStar(start, heuristic, ctx, path, stats));
+	CHECK((int)path.size() == nDistance);
+	CHECK(replayBoardMoves(start, path) == heuristic.getGoal());
+}
+
+//Sampled starts for a goal with the blank in a corner and one with it in the middle are
+//solved by every engine: each path replays to the goal, and every engine but greedy finds
+//the distance database's length. The NxN engines run on the same starts as 3x3 boards,
+//with Manhattan and with pattern databases. A start of the other parity class is unsolvable
+void testEngines()
+{
+	const char* chAlgorithms[] = { "bfs", "db", "bibfs", "greedy", "greedy-wd", "astar", "astar-toop", "astar-lc", "astar-wd",
+		"ida", "ida-toop", "ida-lc", "ida-wd", "biastar", "biastar-lc", "biastar-wd" };
+	int nGoals[2][9] = { { 1, 2, 3, 4, 5, 6, 7, 8, 0 }, { 1, 2, 3, 4, 0, 5, 6, 7, 8 } };
+	vector< vector<int> > vGroups;
+	getTestPatternGroups(vGroups);
+	SearchContext ctx;
+	SearchResult result;
+	BoardSearchContext<3> boardCtx;
+	for (int g = 0; g < 2; g++)
+	{
+		PackedState goal = packState(nGoals[g]);
+		DistanceDatabase db;
+		CHECK(db.open(goal));
+		vector<PackedState> vStarts;
+		for (int i = 0; i < TEST_ENGINE_STARTS; i++)
+			vStarts.push_back(unrankState((int)(g_Rng() % NUM_STATE_RANKS), getStateParity(goal)));
+		PackedState unsolvable = unrankState((int)(g_Rng() % NUM_STATE_RANKS), 1 - getStateParity(goal));
+
+		for (size_t a = 0; a < sizeof(chAlgorithms) / sizeof(chAlgorithms[0]); a++)
+		{
+			SolverAlgorithm algorithm;
+			CHECK(getSolverAlgorithm(chAlgorithms[a], algorithm));
+			for (size_t i = 0; i < vStarts.size(); i++)
+			{
+				CHECK(solvePuzzle(vStarts[i], goal, algorithm, ctx, result));
+				CHECK(replayMoves(vStarts[i], result.m_Path) == goal);
+				if (algorithm.m_Engine == ENGINE_GREEDY)
+					CHECK((int)result.m_Path.size() >= db.getDistance(vStarts[i]));
+				else
+					CHECK((int)result.m_Path.size() == db.getDistance(vStarts[i]));
+			}
+			CHECK(!solvePuzzle(unsolvable, goal, algorithm, ctx, result));
+		}
+
+		MoveString path;
+		for (size_t i = 0; i < vStarts.size(); i += 10) //every call sweeps whole layers, so a tenth of the starts
+		{
+			CHECK(solveParallelBFS(vStarts[i], goal, 2, path));
+			CHECK((int)path.size() == db.getDistance(vStarts[i]));
+			CHECK(replayMoves(vStarts[i], path) == goal);
+		}
+		CHECK(!solveParallelBFS(unsolvable, goal, 2, path));
+
+		BoardState<3> boardGoal = packBoard<3>(nGoals[g]);
+		BoardManhattan<3> manhattan;
+		manhattan.build(boardGoal);
+		AdditivePatternHeuristic<3> patterns;
+		CHECK(patterns.build(boardGoal, vGroups));
+		for (size_t i = 0; i < vStarts.size(); i++)
+		{
+			int nTiles[9];
+			unpackState(vStarts[i], nTiles);
+			BoardState<3> start = packBoard<3>(nTiles);
+			checkBoardSolves(start, manhattan, boardCtx, db.getDistance(vStarts[i]));
+			checkBoardSolves(start, patterns, boardCtx, db.getDistance(vStarts[i]));
+		}
+	}
+}
+
+template<class H>
+bool isBoardHeuristicExact(H &heuristic, PackedState goal, DistanceDatabase &db, bool &bIncremental)
+{
+	bool bAdmissible = true;
+	for (int rank = 0; rank < NUM_STATE_RANKS; rank++)
+	{
+		int nTiles[9];
+		PackedState packed = unrankState(rank, getStateParity(goal));
+		unpackState(packed, nTiles);
+		BoardState<3> state = packBoard<3>(nTiles);
+		int h = heuristic.evaluate(state);
+		if (h > db.getDistance(packed))
+			bAdmissible = false;
+		const BoardMoves &moves = getBoardMoves(state);
+		for (int i = 0; i < moves.m_nCount; i++)
+		{
+			BoardState<3> child = slideBoardTile(state, moves.m_nMoves[i]);
+			if (heuristic.getChildValue(state, h, child) != heuristic.evaluate(child))
+				bIncremental = false;
+		}
+	}
+	return bAdmissible;
+}
+
+//Over every state of the goal's parity class, each heuristic is at most the database
+//distance, and its incremental value for every child (with the heuristic key, for the
+//3x3 tables) matches a full evaluation of the child
+void testHeuristicBounds()
+{
+	int nGoal[9] = { 1, 2, 3, 4, 5, 6, 7, 8, 0 };
+	PackedState goal = packState(nGoal);
+	DistanceDatabase db;
+	CHECK(db.open(goal));
+
+	HeuristicType types[] = { H_MISPLACED, H_MANHATTAN, H_LINEAR_CONFLICT, H_WALKING_DISTANCE };
+	for (int t = 0; t < 4; t++)
+	{
+		Heuristic heuristic;
+		heuristic.build(goal, types[t]);
+		bool bAdmissible = true;
+		bool bIncremental = true;
+		for (int rank = 0; rank < NUM_STATE_RANKS; rank++)
+		{
+			PackedState state = unrankState(rank, getStateParity(goal));
+			uint32_t nKey;
+			int h = heuristic.evaluate(state, nKey);
+			if (h > db.getDistance(state))
+				bAdmissible = false;
+			const PackedMoves &moves = getPackedMoves(state);
+			for (int i = 0; i < moves.m_nCount; i++)
+			{
+				PackedState child = slidePackedTile(state, moves.m_nMoves[i]);
+				uint32_t nChildKey = nKey;
+				uint32_t nFullKey;
+				if (heuristic.getChildValue(state, h, nChildKey, child) != heuristic.evaluate(child, nFullKey) || nChildKey != nFullKey)
+					bIncremental = false;
+			}
+		}
+		CHECK(bAdmissible);
+		CHECK(bIncremental);
+	}
+
+	BoardState<3> boardGoal = packBoard<3>(nGoal);
+	vector< vector<int> > vGroups;
+	getTestPatternGroups(vGroups);
+	BoardManhattan<3> manhattan;
+	manhattan.build(boardGoal);
+	AdditivePatternHeuristic<3> patterns;
+	CHECK(patterns.build(boardGoal, vGroups));
+	bool bIncremental = true;
+	CHECK(isBoardHeuristicExact(manhattan, goal, db, bIncremental));
+	CHECK(bIncremental);
+	CHECK(isBoardHeuristicExact(patterns, goal, db, bIncremental));
+	CHECK(bIncremental);
+}
+
+//As the 3x3 set below, for NxN boards: random boards are found once inserted, through
+//growth from the smallest capacity, and a board one move away from each is not
+template<int N>
+void testBoardVisitedSet()
+{
+	BasicNodePool< BoardState<N>, BoardNode<N> > pool(256);
+	BasicVisitedSet< BoardState<N>, BoardNode<N> > visited(1);
+	vector< BoardNode<N>* > vNodes;
+	for (int i = 0; i < 3000; i++)
+	{
+		int nTiles[N * N];
+		shuffleTiles<N>(nTiles);
+		BoardNode<N>* node = pool.createNode(packBoard<N>(nTiles));
+		if (visited.insert(node->getState(), node))
+			vNodes.push_back(node);
+	}
+	CHECK(visited.getSize() == vNodes.size());
+	CHECK(visited.getLoadFactor() <= 0.7);
+	bool bFound = true;
+	bool bNeighborsAbsent = true;
+	for (size_t i = 0; i < vNodes.size(); i++)
+	{
+		const BoardState<N> &state = vNodes[i]->getState();
+		if (visited.find(state) != vNodes[i] || visited.insert(state, nullptr))
+			bFound = false;
+		BoardState<N> neighbor = slideBoardTile(state, getBoardMoves(state).m_nMoves[0]);
+		if (visited.contains(neighbor) && find(vNodes.begin(), vNodes.end(), visited.find(neighbor)) == vNodes.end())
+			bNeighborsAbsent = false;
+	}
+	CHECK(bFound);
+	CHECK(bNeighborsAbsent);
+}
+
+//The visited set keeps every state it was given, and no other, as it doubles from its
+//smallest capacity; replace swaps a state's node and clear keeps the capacity. The node
+//pool links children to their parents, hands the same slots out again after releaseAll,
+//and counts blocks, nodes in use and the peak
+void testSearchMemory()
+{
+	NodePool pool(1000);
+	VisitedSet visited(1);
+	CHECK(visited.getCapacity() == 16);
+	vector<Node*> vNodes;
+	for (int r = 0; r < 5000; r++)
+	{
+		Node* node = pool.createNode(unrankState(r * 36, 0));
+		vNodes.push_back(node);
+		CHECK(visited.insert(node->getState(), node));
+	}
+	CHECK(visited.getSize() == 5000);
+	CHECK(visited.getCapacity() == 8192);
+	CHECK(visited.getLoadFactor() <= 0.7);
+	CHECK(pool.getNodesInUse() == 5000);
+	CHECK(pool.getBytesReserved() == 5 * 1000 * sizeof(Node));
+
+	bool bFound = true;
+	bool bOthersAbsent = true;
+	for (int r = 0; r < 5000; r++)
+	{
+		if (visited.find(vNodes[r]->getState()) != vNodes[r] || visited.insert(vNodes[r]->getState(), nullptr))
+			bFound = false;
+		if (visited.contains(unrankState(r * 36 + 1, 0)) || visited.contains(unrankState(r * 36, 1)))
+			bOthersAbsent = false;
+	}
+	CHECK(bFound);
+	CHECK(bOthersAbsent);
+	CHECK(visited.getSize() == 5000);
+	CHECK(visited.getMaxProbeLength() >= 1);
+
+	visited.replace(vNodes[0]->getState(), vNodes[1]);
+	CHECK(visited.find(vNodes[0]->getState()) == vNodes[1]);
+	visited.clear();
+	CHECK(visited.getSize() == 0);
+	CHECK(visited.getCapacity() == 8192);
+	CHECK(!visited.contains(vNodes[0]->getState()));
+
+	PackedState root = vNodes[0]->getState();
+	int move = getPackedMoves(root).m_nMoves[0];
+	Node* child = pool.createNode(root, move, vNodes[0]);
+	CHECK(child->getParent() == vNodes[0]);
+	CHECK(child->getDepth() == 2);
+	CHECK(child->getAction() == move);
+	CHECK(child->getState() == slidePackedTile(root, move));
+	CHECK(pool.getPeakNodesInUse() == 5001);
+	pool.releaseLast();
+	CHECK(pool.getNodesInUse() == 5000);
+	CHECK(pool.createNode(root) == child); //the released slot is handed out again
+
+	pool.releaseAll();
+	CHECK(pool.getNodesInUse() == 0);
+	CHECK(pool.getPeakNodesInUse() == 5001);
+	pool.resetPeak();
+	CHECK(pool.getPeakNodesInUse() == 0);
+	bool bReused = true;
+	for (int r = 0; r < 5000; r++)
+		if (pool.createNode(root) != vNodes[r])
+			bReused = false;
+	CHECK(bReused);
+	CHECK(pool.getBytesReserved() == 6 * 1000 * sizeof(Node)); //the block the child started is kept too
+	CHECK(pool.getPeakBytesUsed() == 5000 * sizeof(Node));
+
+	testBoardVisitedSet<4>();
+	testBoardVisitedSet<5>();
+}
+
+int main()
+{
+	testBoardPacking<3>();
+	testBoardPacking<4>();
+	testBoardPacking<5>();
+	testBoardMoves<3>();
+	testBoardMoves<4>();
+	testBoardMoves<5>();
+	testPackedCanonicalizer();
+	testBoardCanonicalizer<4>();
+	testBoardCanonicalizer<5>();
+	testBucketQueue();
+	testMoveString();
+	testBatchHeuristics();
+	testBoardParity<3>();
+	testBoardParity<4>();
+	testBoardParity<5>();
+	testStateRanks();
+	testBinaryRecords<3>();
+	testBinaryRecords<4>();
+	testBinaryRecords<5>();
+	testTextRecords();
+	testSearchMemory();
+	testHeuristicBounds();
+	testEngines();
+
+	cout << g_nChecks << " checks, " << g_nFailures << " failed.\n";
+	return (g_nFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+/////////////////////////////////////////////////////////////
+// Visited set for eight_tile_solver.
+//
+// Open-addressing hash table keyed on a board state, giving O(1) duplicate
+// detection for the search algorithms. Each slot holds the state's key and
+// the node that reached that state (A* replaces it when a cheaper path to
+// the state is found). Capacity is always a power of two
+// and the table doubles once it is 70% full. Linear probing is used, with
+// probe counts recorded so the table's health can be reported.
+// The table is templated on the state type S and node type T, so the 3x3
+// engines (VisitedSet, keyed on PackedState) and the NxN engines (keyed on
+// BoardState<N>, see nxn_search.h) share one implementation. VisitedKey<S>
+// gives the key a slot stores for S: the packed tiles alone for PackedState,
+// so a 3x3 slot stays 16 bytes.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "packed_state.h"
+#include "nxn_board.h"
+
+using namespace std;
+
+class Node;
+
+//Key a slot stores for a state of type S. A value-initialized key marks an empty slot;
+//no valid board packs to one
+template<class S> struct VisitedKey;
+
+template<>
+struct VisitedKey<PackedState>
+{
+	typedef uint64_t Type;
+	static Type getKey(const PackedState &state) { return state.m_nTiles; }
+	static uint64_t getHash(const Type &key) { PackedState state = { key, 0 }; return getStateHash(state); }
+	static bool isEmpty(const Type &key) { return key == 0; }
+};
+
+template<int N>
+struct VisitedKey< BoardState<N> >
+{
+	typedef BoardState<N> Type;
+	static Type getKey(const BoardState<N> &state) { return state; }
+	static uint64_t getHash(const Type &key) { return getBoardHash(key); }
+	static bool isEmpty(const Type &key) { return key.m_nWords[0] == 0; } //Word 0 holds several positions, and only one can be blank
+};
+
+template<class S, class T>
+class BasicVisitedSet
+{
+public:
+	BasicVisitedSet(unsigned int nCapacity = 1024);	//Capacity is rounded up to a power of two
+	bool insert(const S &state, T* node);			//Adds state. Returns false if it was already present
+	void replace(const S &state, T* node);			//Stores node for a state already present (ex: a cheaper path to it)
+	bool contains(const S &state);
+	T* find(const S &state);						//Returns the node stored for state, or nullptr
+	void clear();									//Empties the table but keeps its capacity
+	unsigned int getSize();							//Accessors..
+	unsigned int getCapacity();
+	size_t getBytesReserved();						//Bytes held in slots
+	double getLoadFactor();
+	double getAverageProbeLength();					//Average slots examined per lookup/insert
+	unsigned int getMaxProbeLength();				//Longest probe sequence seen
+
+protected:
+	typedef VisitedKey<S> Keys;
+	typedef typename Keys::Type Key;
+
+	struct Slot
+	{
+		Key m_Key;			// Key of the state, all zero = empty
+		T* m_pNode;
+	};
+
+	unsigned int findSlot(const Key &key);			//Returns index of the slot holding key, or of the empty slot where it belongs
+	unsigned int probeSlot(const Key &key, unsigned int &nProbe);	//As findSlot, without recording probe statistics
+	void grow();									//Doubles capacity and rehashes every entry
+
+	vector<Slot> m_vSlots;
+	unsigned int m_nMask;		// Capacity - 1, used in place of a modulus
+	unsigned int m_nSize;
+	uint64_t m_nLookups;		// Probe statistics
+	uint64_t m_nProbes;
+	unsigned int m_nMaxProbe;
+};
+
+typedef BasicVisitedSet<PackedState, Node> VisitedSet;	// The 3x3 engines' table
+
+//Constructor
+template<class S, class T>
+BasicVisitedSet<S, T>::BasicVisitedSet(unsigned int nCapacity) : m_nSize(0), m_nLookups(0), m_nProbes(0), m_nMaxProbe(0)
+{
+	unsigned int nPow2 = 16;
+	while (nPow2 < nCapacity)
+		nPow2 <<= 1;
+	Slot empty = { Key(), nullptr };
+	m_vSlots.assign(nPow2, empty);
+	m_nMask = nPow2 - 1;
+}
+
+//Adds state, grows the table first if it would become too full.
+//Returns false if the state was already present (node is then ignored)
+template<class S, class T>
+bool BasicVisitedSet<S, T>::insert(const S &state, T* node)
+{
+	if ((m_nSize + 1) * 10 > m_vSlots.size() * 7)
+		grow();
+
+	Key key = Keys::getKey(state);
+	unsigned int nIndex = findSlot(key);
+	if (!Keys::isEmpty(m_vSlots[nIndex].m_Key))
+		return false;
+
+	m_vSlots[nIndex].m_Key = key;
+	m_vSlots[nIndex].m_pNode = node;
+	m_nSize++;
+	return true;
+}
+
+//Stores node for a state already present. Does nothing if the state is absent.
+template<class S, class T>
+void BasicVisitedSet<S, T>::replace(const S &state, T* node)
+{
+	unsigned int nIndex = findSlot(Keys::getKey(state));
+	if (!Keys::isEmpty(m_vSlots[nIndex].m_Key))
+		m_vSlots[nIndex].m_pNode = node;
+}
+
+template<class S, class T>
+bool BasicVisitedSet<S, T>::contains(const S &state)
+{
+	return !Keys::isEmpty(m_vSlots[findSlot(Keys::getKey(state))].m_Key);
+}
+
+template<class S, class T>
+T* BasicVisitedSet<S, T>::find(const S &state)
+{
+	return m_vSlots[findSlot(Keys::getKey(state))].m_pNode;
+}
+
+template<class S, class T>
+void BasicVisitedSet<S, T>::clear()
+{
+	Slot empty = { Key(), nullptr };
+	m_vSlots.assign(m_vSlots.size(), empty);
+	m_nSize = 0;
+	m_nLookups = 0;
+	m_nProbes = 0;
+	m_nMaxProbe = 0;
+}
+
+//Probe for a lookup or insert, recorded in the table's statistics
+template<class S, class T>
+unsigned int BasicVisitedSet<S, T>::findSlot(const Key &key)
+{
+	unsigned int nProbe;
+	unsigned int nIndex = probeSlot(key, nProbe);
+	m_nLookups++;
+	m_nProbes += nProbe;
+	if (nProbe > m_nMaxProbe)
+		m_nMaxProbe = nProbe;
+	return nIndex;
+}
+
+//Linear probe from the state's home slot until its key or an empty slot is found.
+//nProbe is set to the number of slots examined
+template<class S, class T>
+unsigned int BasicVisitedSet<S, T>::probeSlot(const Key &key, unsigned int &nProbe)
+{
+	unsigned int nIndex = (unsigned int)Keys::getHash(key) & m_nMask;
+	nProbe = 1;
+	while (!Keys::isEmpty(m_vSlots[nIndex].m_Key) && !(m_vSlots[nIndex].m_Key == key))
+	{
+		nIndex = (nIndex + 1) & m_nMask;
+		nProbe++;
+	}
+	return nIndex;
+}
+
+//Doubles capacity and reinserts every entry. Reinserts aren't lookups, so they
+//are left out of the probe statistics
+template<class S, class T>
+void BasicVisitedSet<S, T>::grow()
+{
+	vector<Slot> vOld;
+	vOld.swap(m_vSlots);
+	Slot empty = { Key(), nullptr };
+	m_vSlots.assign(vOld.size() * 2, empty);
+	m_nMask = (unsigned int)m_vSlots.size() - 1;
+
+	unsigned int nProbe;
+	for (unsigned int i = 0; i < vOld.size(); i++)
+		if (!Keys::isEmpty(vOld[i].m_Key))
+			m_vSlots[probeSlot(vOld[i].m_Key, nProbe)] = vOld[i];
+}
+
+//Accessors
+template<class S, class T>
+unsigned int BasicVisitedSet<S, T>::getSize()
+{
+	return m_nSize;
+}
+template<class S, class T>
+unsigned int BasicVisitedSet<S, T>::getCapacity()
+{
+	return (unsigned int)m_vSlots.size();
+}
+template<class S, class T>
+size_t BasicVisitedSet<S, T>::getBytesReserved()
+{
+	return m_vSlots.size() * sizeof(Slot);
+}
+template<class S, class T>
+double BasicVisitedSet<S, T>::getLoadFactor()
+{
+	return (double)m_nSize / m_vSlots.size();
+}
+template<class S, class T>
+double BasicVisitedSet<S, T>::getAverageProbeLength()
+{
+	if (m_nLookups == 0)
+		return 0.0;
+	return (double)m_nProbes / m_nLookups;
+}
+template<class S, class T>
+unsigned int BasicVisitedSet<S, T>::getMaxProbeLength()
+{
+	return m_nMaxProbe;
+}
@@ -0,0 +1,132 @@
+/////////////////////////////////////////////////////////////
+// Work-stealing task scheduler for eight_tile_solver.
+//
+// Runs tasks 0..n-1 on a set of threads. Every thread starts with its own
+// deque holding a contiguous range of tasks, takes work from the front of its
+// deque, and when it runs dry steals from the back of another thread's. Puzzle
+// costs vary by orders of magnitude, so stealing keeps every core busy until
+// the last task is done. Each deque has its own lock, so threads only contend
+// when stealing.
+// Includes interface and implementation.
+//
+/// Dustin Fast (dustin.fast@outlook.com), 2016
+
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <functional>
+
+using namespace std;
+
+//One thread's queue of task numbers
+struct TaskDeque
+{
+	mutex m_Lock;
+	deque<unsigned int> m_Tasks;
+};
+
+class WorkStealingScheduler
+{
+public:
+	WorkStealingScheduler(unsigned int nThreads);
+	unsigned int getThreadCount();
+	void run(unsigned int nTasks, function<void(unsigned int nThread, unsigned int nTask)> task); //Calls task for every task number, returning when all are done
+	unsigned int getSteals(); //Tasks taken from another thread's deque during the last run
+
+protected:
+	void doWork(unsigned int nThread, function<void(unsigned int, unsigned int)> &task);
+	bool popOwn(unsigned int nThread, unsigned int &nTask);
+	bool steal(unsigned int nThread, unsigned int &nTask);
+
+	unsigned int m_nThreads;
+	vector<TaskDeque> m_vDeques;	// [nThread] = that thread's tasks
+	vector<unsigned int> m_vSteals;	// [nThread] = tasks it stole, written only by that thread
+};
+
+//Constructor. nThreads of 0 uses one thread per hardware thread
+WorkStealingScheduler::WorkStealingScheduler(unsigned int nThreads) : m_nThreads(nThreads)
+{
+	if (m_nThreads == 0)
+		m_nThreads = thread::hardware_concurrency();
+	if (m_nThreads == 0)
+		m_nThreads = 1; //hardware_concurrency may not know
+	m_vDeques = vector<TaskDeque>(m_nThreads);
+	m_vSteals.assign(m_nThreads, 0);
+}
+
+unsigned int WorkStealingScheduler::getThreadCount()
+{
+	return m_nThreads;
+}
+
+//Deals tasks out in contiguous ranges, runs task(nThread, nTask) for each on the
+//worker threads (the calling thread is worker 0) and waits for all of them
+void WorkStealingScheduler::run(unsigned int nTasks, function<void(unsigned int nThread, unsigned int nTask)> task)
+{
+	for (unsigned int t = 0; t < m_nThreads; t++)
+	{
+		m_vDeques[t].m_Tasks.clear();
+		unsigned int nFirst = (unsigned int)((uint64_t)nTasks * t / m_nThreads);
+		unsigned int nLast = (unsigned int)((uint64_t)nTasks * (t + 1) / m_nThreads);
+		for (unsigned int i = nFirst; i < nLast; i++)
+			m_vDeques[t].m_Tasks.push_back(i);
+		m_vSteals[t] = 0;
+	}
+
+	vector<thread> vWorkers;
+	for (unsigned int t = 1; t < m_nThreads; t++)
+		vWorkers.push_back(thread(&WorkStealingScheduler::doWork, this, t, ref(task)));
+	doWork(0, task);
+	for (unsigned int i = 0; i < vWorkers.size(); i++)
+		vWorkers[i].join();
+}
+
+unsigned int WorkStealingScheduler::getSteals()
+{
+	unsigned int nSteals = 0;
+	for (unsigned int t = 0; t < m_nThreads; t++)
+		nSteals += m_vSteals[t];
+	return nSteals;
+}
+
+//Worker loop. Tasks are never added during a run, so once every deque
+//has been found empty there is no more work
+void WorkStealingScheduler::doWork(unsigned int nThread, function<void(unsigned int, unsigned int)> &task)
+{
+	unsigned int nTask;
+	while (popOwn(nThread, nTask) || steal(nThread, nTask))
+		task(nThread, nTask);
+}
+
+//Takes the next task from the front of the thread's own deque
+bool WorkStealingScheduler::popOwn(unsigned int nThread, unsigned int &nTask)
+{
+	TaskDeque &own = m_vDeques[nThread];
+	lock_guard<mutex> lock(own.m_Lock);
+	if (own.m_Tasks.empty())
+		return false;
+	nTask = own.m_Tasks.front();
+	own.m_Tasks.pop_front();
+	return true;
+}
+
+//Takes a task from the back of another thread's deque, trying each in turn starting with the next thread
+bool WorkStealingScheduler::steal(unsigned int nThread, unsigned int &nTask)
+{
+	for (unsigned int i = 1; i < m_nThreads; i++)
+	{
+		TaskDeque &victim = m_vDeques[(nThread + i) % m_nThreads];
+		lock_guard<mutex> lock(victim.m_Lock);
+		if (victim.m_Tasks.empty())
+			continue;
+		nTask = victim.m_Tasks.back();
+		victim.m_Tasks.pop_back();
+		m_vSteals[nThread]++;
+		return true;
+	}
+	return false;
+}